@@ -4,11 +4,13 @@ from . import taskdmrg
 from . import multioperator
 
 def dynamical_correlator(self,es=np.linspace(0.,10.0,100),
-        delta=1e-1,name="XX",i=0,j=0):
+        delta=1e-1,name="XX",i=0,j=0,grid=True):
     """
     Compute the dynamical correlator using CVM method in DMRG
     """
     if not self.computed_gs: self.get_gs() # compute ground state
+    if grid: # all the energies in a single run
+        return cvm_dmrg_grid(self,name=name,i=i,j=j,delta=delta,es=es)
     out = [] # empty list
     for e in es: # loop over energies
         print("CVM in E = ",e)
@@ -28,6 +30,14 @@ def dynamical_correlator(self,es=np.linspace(0.,10.0,100),
 
 
 
+def cg_task(self):
+    """Options of the preconditioner of the CG solver, with cvm_solver=cg"""
+    return {"cg_precondition":str(self.cg_precondition).lower(),
+            "cg_precondition_nit":str(int(self.cg_precondition_nit)),
+            "cg_precondition_maxm":str(int(self.cg_precondition_maxm))}
+
+
+
 def cvm_dmrg(self,name="XX",delta=1e-1,e=0.0,**kwargs):
     """
     Return the dynamical correlator for a single energy
@@ -42,7 +52,9 @@ def cvm_dmrg(self,name="XX",delta=1e-1,e=0.0,**kwargs):
             "cvm_e0":str(self.e0),
             "cvm_nit":str(int(self.cvm_nit)),
             "cvm_tol":str(self.cvm_tol),
+            "cvm_solver":self.cvm_solver,
             }
+    task.update(cg_task(self)) # preconditioner of CG
     self.task = task # override tasks
 #    name[0] = name[0].get_dagger()
     A = name[0]
@@ -57,6 +69,37 @@ def cvm_dmrg(self,name="XX",delta=1e-1,e=0.0,**kwargs):
 
 
 
+def cvm_dmrg_grid(self,name="XX",delta=1e-1,es=np.linspace(0.,10.0,100),
+        **kwargs):
+    """
+    Return the dynamical correlator for a grid of energies
+    """
+    name = operatornames.str2MO(self,name,**kwargs)
+    task = {"cvm_grid":"true",
+            "cvm_delta":str(delta),
+            "cvm_e0":str(self.e0),
+            "cvm_nit":str(int(self.cvm_nit)),
+            "cvm_tol":str(self.cvm_tol),
+            "cvm_solver":self.cvm_solver,
+            }
+    task.update(cg_task(self)) # preconditioner of CG
+    self.task = task # override tasks
+    A = name[0]
+    B = name[1]
+    def write_energies(): # write the frequencies
+        np.savetxt("cvm_energies.in",es,header=str(len(es)),comments="")
+    self.execute(write_energies)
+    self.execute(lambda: A.write(name="dc_multioperator_i.in"))
+    self.execute(lambda: B.write(name="dc_multioperator_j.in"))
+    self.execute( lambda : taskdmrg.write_tasks(self)) # write tasks
+    self.execute( lambda : self.run()) # run calculation
+    cs = np.atleast_2d(self.get_file("CVM_GRID.OUT")).transpose() # read
+    gs = cs[1] + 1j*cs[2] # Green's function
+    return (es,-gs.imag/np.pi) # return result
+
+
+
+
 def dynamical_correlator_analytic_continuation(self,name=None,
         delta=1e-1,es=np.linspace(0.,5.0,300)):
     """
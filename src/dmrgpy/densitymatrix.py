@@ -2,10 +2,11 @@
 from . import taskdmrg
 import numpy as np
 
-def reduced_dm(self,i=0):
+def reduced_dm(self,i=0,sites=None,wf=None):
     """
     Compute the reduced density matrix
     """
+    if sites is not None: return reduced_dm_subset(self,sites=sites,wf=wf)
     self.get_gs() # compute ground state
     task = {"density_matrix":"true",
             "index_i_DM":str(i+1)
@@ -22,6 +23,31 @@ def reduced_dm(self,i=0):
 
 
 
+def reduced_dm_subset(self,sites=[0],wf=None):
+    """
+    Compute the reduced density matrix of several sites, not necessarily
+    contiguous, of the state wf (the ground state if None). The basis
+    is the product of the sites in increasing order, the first one being
+    the slowest index
+    """
+    if wf is None: wf = self.get_gs() # compute ground state
+    self.execute(lambda: wf.write(name="wavefunction.mps"))
+    task = {"density_matrix_subset":"true",
+            "rdm_nsites":str(len(sites)),
+            }
+    for (k,i) in enumerate(sites): task["rdm_site_"+str(k)] = str(i)
+    self.task = task # add the tasks
+    self.write_task() # write the tasks
+    self.run() # run the calculation
+    def read(): # read the binary file
+        f = open("DM.BIN","rb")
+        n = np.fromfile(f,dtype=np.int32,count=1)[0] # number of sites
+        d = np.prod(np.fromfile(f,dtype=np.int32,count=n)) # dimension
+        return np.fromfile(f,dtype=np.complex128).reshape((d,d))
+    return self.execute(read)
+
+
+
 def reduced_dm_projective(self,wf,i=0,j=None):
     """Compute the reduced density matrix using a brute force approach"""
     def projectors(k):
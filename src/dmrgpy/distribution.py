@@ -25,6 +25,30 @@ def get_moments_distribution(self,X=None,num_p=None):
 
 
 
+def get_moments_distribution_batch(self,Xs,num_p):
+  """Get the moments of several operators with DMRG, in a single run"""
+  self.gs_energy()
+  task = {      "distribution_batch": "true",
+                "kpmmaxm":str(self.kpmmaxm),
+                "kpm_num_polynomials":str(num_p),
+                "kpm_distribution_noperators":str(len(Xs)),
+                "kpm_cutoff":str(self.kpmcutoff),
+                }
+  for (k,X) in enumerate(Xs): # write all the operators
+      name = "kpm_distribution_multioperator_"+str(k)+".in"
+      self.execute(lambda: X.write(name=name))
+  self.task = task # assign tasks
+  self.write_task()
+  self.write_hamiltonian() # write the Hamiltonian to a file
+  self.run() # perform the calculation
+  def read(): # read the binary file
+      f = open("KPM_MOMENTS_DISTRIBUTION.BIN","rb")
+      (nop,nm) = np.fromfile(f,dtype=np.int32,count=2)
+      return np.fromfile(f,dtype=np.complex128).reshape((nop,nm))
+  return self.execute(read)
+
+
+
 
 
 def get_distribution(self,**kwargs):
@@ -2,6 +2,7 @@ from . import kpmdmrg
 from . import timedependent
 from . import cvm
 from . import dcex
+from . import lanczos
 
 def get_dynamical_correlator(self,submode="KPM",**kwargs):
     self.set_initial_wf(self.wf0) # set the initial wavefunction
@@ -11,6 +12,8 @@ def get_dynamical_correlator(self,submode="KPM",**kwargs):
         return timedependent.dynamical_correlator(self,**kwargs)
     elif submode=="CVM": # CVM mode
         return cvm.dynamical_correlator(self,**kwargs)
+    elif submode=="Lanczos": # Lanczos continued fraction
+        return lanczos.dynamical_correlator(self,**kwargs)
     elif submode=="CVMimag": # CVM mode
         return cvm.dynamical_correlator_analytic_continuation(self,**kwargs)
     elif submode=="EX": # EX mode
@@ -16,12 +16,34 @@ def gmean(x):
 
 def compute_entropy(self,psi,b=1):
     if b is None:
-        out = np.array([compute_entropy_single(self,psi,b=i) 
-            for i in range(1,self.ns)])
+        out = np.abs(entanglement_profile(self,psi)["entropy"])
         return gmean(out)
     else: return compute_entropy_single(self,psi,b=b)
 
 
+
+def entanglement_profile(self,psi,renyi=[2]):
+    """Compute the entanglement of all the bonds in a single sweep.
+    Returns a dictionary with the bond dimensions, the von Neumann
+    entropies, the Renyi entropies (bonds,orders) of the orders in renyi
+    and the Schmidt spectrum of each bond"""
+    self.execute(lambda: psi.write(name="wavefunction.mps"))
+    task = {    "entanglement_profile": "true",
+                "entanglement_nrenyi":str(len(renyi)),
+                }
+    for (k,n) in enumerate(renyi): task["entanglement_renyi_"+str(k)] = str(n)
+    self.task = task # assign tasks
+    self.write_task()
+    self.run() # perform the calculation
+    m = self.execute(lambda: np.genfromtxt("ENTANGLEMENT_PROFILE.OUT"))
+    m = np.atleast_2d(m)
+    def read(): # one line per bond, of different length
+        ls = open("ENTANGLEMENT_SPECTRUM.OUT").readlines()
+        return [np.array([float(x) for x in l.split()[1:]]) for l in ls]
+    return {"bond_dimension":m[:,1].astype(int),"entropy":m[:,2],
+            "renyi":m[:,3:],"spectrum":self.execute(read)}
+
+
 def compute_entropy_single(self,psi,b=1):
     """Compute entanglement entropy in a bond"""
     if b<1 or b>self.ns: raise
@@ -67,3 +89,28 @@ def entropy_dm(dm,normalize=False):
 
 
 
+
+
+
+def mutual_information(self,wf=None):
+    """Compute the single site entropies and the mutual information
+    matrix I(i,j) of all the pairs of sites, in a single run"""
+    if wf is None: wf = self.get_gs() # compute ground state
+    self.execute(lambda: wf.write(name="wavefunction.mps"))
+    self.task = {"mutual_information": "true"} # assign tasks
+    self.write_task()
+    self.run() # perform the calculation
+    s = self.execute(lambda: np.genfromtxt("SITE_ENTROPY.OUT"))
+    mi = self.execute(lambda: np.genfromtxt("MUTUAL_INFORMATION.OUT"))
+    return np.atleast_2d(s)[:,1],np.atleast_2d(mi)
+
+
+
+def mutual_information_ordering(mi):
+    """Return an ordering of the sites that keeps the strongly entangled
+    ones close, using the Fiedler vector of the mutual information.
+    The sites of the chain are then [sites[i] for i in ordering]"""
+    L = np.diag(np.sum(mi,axis=1)) - mi # Laplacian of the graph
+    from scipy.linalg import eigh
+    (es,vs) = eigh(L)
+    return np.argsort(vs[:,1]) # ordering given by the Fiedler vector
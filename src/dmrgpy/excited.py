@@ -3,17 +3,28 @@ from . import mps
 from scipy import linalg as lg
 
 
-def get_excited_states_dmrg(self,n=2,noise=0.0,scale=10.0):
-    """Return excited state energies"""
-    self.get_gs()
+def excited_task(self,n=2,noise=0.0,scale=10.0,variance_tol=0.0,
+        max_attempts=1):
+    """Options of the DMRG of the excited states"""
     if self.excited_gram_schmidt: sm = "true"
     else: sm = "false"
-    task = {"excited":"true",
-            "nexcited":str(n),
+    return {"nexcited":str(n),
             "noise":str(noise),
             "excited_gram_schmidt":sm,
             "scale_lagrange_excited":str(scale),
+            "excited_variance_tol":str(variance_tol),
+            "excited_max_attempts":str(max_attempts),
             }
+
+
+def get_excited_states_dmrg(self,**kwargs):
+    """Return excited state energies, the DMRG of each excited state is
+    continued (up to max_attempts times) until its energy variance is
+    below variance_tol"""
+    self.get_gs()
+    task = {"excited":"true"}
+    task.update(excited_task(self,**kwargs)) # excited states
+    n = int(task["nexcited"]) # number of states
     self.task = task
     self.write_task()
     self.write_hamiltonian() # write the Hamiltonian to a file
@@ -26,6 +37,33 @@ def get_excited_states_dmrg(self,n=2,noise=0.0,scale=10.0):
     return out[0],wfs # return energies and wavefunctions 
 
 
+def get_excited_matrix_elements(self,ops,**kwargs):
+    """Return the energies of the excited states, computed as in
+    get_excited_states, and the tensor of matrix elements
+    M[k,i,j] = <i|ops[k]|j>, as needed in the Lehmann representation
+    of the spectral functions"""
+    from .multioperator import obj2MO
+    if type(ops)!=list: ops = [ops]
+    self.get_gs()
+    task = {"excited_matrix_elements":"true",
+            "excited_me_noperators":str(len(ops)),
+            }
+    task.update(excited_task(self,**kwargs)) # excited states
+    for (k,A) in enumerate(ops):
+        A = obj2MO(A) # convert to a MO
+        self.execute(lambda: A.write(name="excited_me_multioperator_"+str(k)+".in"))
+    self.task = task
+    self.write_task()
+    self.write_hamiltonian() # write the Hamiltonian to a file
+    self.run() # perform the calculation
+    es = self.execute(lambda: np.genfromtxt("EXCITED.OUT").T)[0]
+    def read(): # read the binary file
+        f = open("EXCITED_MATRIX_ELEMENTS.BIN","rb")
+        (nop,ns) = np.fromfile(f,dtype=np.int32,count=2)
+        return np.fromfile(f,dtype=np.complex128).reshape((nop,ns,ns))
+    return np.atleast_1d(es),self.execute(read)
+
+
 def get_excited(*args,**kwargs):
     """Return the excited state energies"""
     (es,ws) = get_excited_states(*args,**kwargs)
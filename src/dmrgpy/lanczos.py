@@ -0,0 +1,53 @@
+import numpy as np
+from . import operatornames
+from . import taskdmrg
+
+def dynamical_correlator(self,es=np.linspace(0.,10.0,100),
+        delta=1e-1,name="XX",i=0,j=0,n=100,reorthogonalize=False):
+    """
+    Compute the dynamical correlator using Lanczos vectors in DMRG
+    """
+    if not self.computed_gs: self.get_gs() # compute ground state
+    (ts,ws) = get_poles(self,name=name,i=i,j=j,n=n,
+            reorthogonalize=reorthogonalize)
+    z = es + self.e0 + 1j*delta # complex frequencies
+    gs = np.array([np.sum(ws/(zi-ts)) for zi in z]) # Green's function
+    return (es,-gs.imag/np.pi) # return result
+
+
+def get_coefficients(self,name="XX",n=100,reorthogonalize=False,**kwargs):
+    """
+    Return the Lanczos coefficients a_n, b_n and the weights <GS|A|v_n>
+    """
+    name = operatornames.str2MO(self,name,**kwargs)
+    if reorthogonalize: reortho = "true"
+    else: reortho = "false"
+    task = {"lanczos_correlator":"true",
+            "lanczos_n":str(int(n)),
+            "lanczos_reorthogonalize":reortho,
+            }
+    self.task = task # override tasks
+    A = name[0]
+    B = name[1]
+    self.execute(lambda: A.write(name="dc_multioperator_i.in"))
+    self.execute(lambda: B.write(name="dc_multioperator_j.in"))
+    self.execute( lambda : taskdmrg.write_tasks(self)) # write tasks
+    self.execute( lambda : self.run()) # run calculation
+    m = self.execute(lambda: np.genfromtxt("LANCZOS_COEFFICIENTS.OUT"))
+    if m.size==0: # A|GS> is zero, no coefficients
+        return (np.zeros(0),np.zeros(0),np.zeros(0,dtype=np.complex128))
+    m = np.atleast_2d(m).transpose() # read
+    return (m[0],m[1],m[2]+1j*m[3])
+
+
+def get_poles(self,**kwargs):
+    """
+    Return the poles and weights of the continued fraction,
+    so that G(z) = sum_k w_k/(z-e_k)
+    """
+    (a,b,c) = get_coefficients(self,**kwargs)
+    if len(a)==0: return (np.zeros(0),np.zeros(0)) # zero correlator
+    T = np.diag(a) + np.diag(b[1:],k=1) + np.diag(b[1:],k=-1) # tridiagonal
+    (ts,U) = np.linalg.eigh(T) # diagonalize
+    ws = b[0]*(c@U)*U[0,:] # weights of each pole
+    return (ts,ws)
@@ -63,8 +63,19 @@ class Many_Body_Chain():
       self.kpmcutoff = 1e-12 # cutoff in KPM
       self.cutoff = 1e-12 # cutoff in ground state
       self.tevol_custom_exp = True # custom exponential function for Tevol
+      self.tevol_exp_mpo = "W2" # MPO of the time step (W1 or W2)
+      self.tevol_exp_order = 2 # order in dt of the MPO of the time step
+      self.tevol_exp_maxm = None # bond dimension of that MPO (no limit)
+      self.tevol_exp_tol = 0.0 # error of that MPO, sets the order if >0
+      self.tevol_exp_error = False # write the error of that MPO
+      self.tevol_method = "mpo" # time evolution (mpo, tdvp, tdvp1, tebd, tebd4, krylov)
       self.cvm_tol = 1e-5 # tolerance for CVM
       self.cvm_nit = 1e3 # iterations for CVM
+      self.cvm_solver = "bicgstab" # solver for CVM (bicgstab, ddmrg or cg)
+      self.cg_precondition = False # precondition CG with a low maxm CG
+      self.cg_precondition_nit = 4 # iterations of that preconditioner
+      self.cg_precondition_maxm = 20 # bond dimension of that preconditioner
+      self.nthreads = 1 # number of threads in mpscpp.x
       self.kpm_scale = 0.7 # scaling of the spectra for KPM
       self.kpm_accelerate = True # set to true
       self.kpm_n_scale = 3 # scaling factor for the number of polynomials
@@ -76,6 +87,13 @@ class Many_Body_Chain():
       self.computed_gs = False # computed the GS already
       self.vijkl = 0 # generalized interaction
       self.fit_td = False # use fitting procedure in time evolution
+      self.tevol_checkpoint = 0 # steps between checkpoints (0 for none)
+      self.tevol_restart = False # continue from the last checkpoint
+      self.tevol_adaptive = False # adaptive time step and bond dimension
+      self.tevol_dt_tol = 1e-4 # error of each step, adaptive evolution
+      self.tevol_truncation = 1e-8 # discarded weight, adaptive evolution
+      self.tevol_maxm_max = None # maximum bond dimension (default maxm)
+      self.tevol_max_substeps = 16 # maximum substeps of each step
       self.itensor_version = 2 # ITensor version
       self.has_ED_obj = False # ED object has been computed
       self.kpm_extrapolate = False # use extrapolation
@@ -204,6 +222,9 @@ class Many_Body_Chain():
   def aMb(self,wf1,M,wf2,**kwargs):
       """Compute the overlap <a|M|b>"""
       return mpsalgebra.overlap_aMb(self,wf1,M,wf2,**kwargs)
+  def gram_matrix(self,wfs,**kwargs):
+      """Return the matrix of overlaps of a list of wavefunctions"""
+      return mpsalgebra.gram_matrix(self,wfs,**kwargs)
   def operator_norm(self,op,**kwargs):
       """Estimate the norm of an operator"""
       return mpsalgebra.operator_norm(self,op,**kwargs)
@@ -277,6 +298,18 @@ class Many_Body_Chain():
       """Return the entanglement entropy of two sites"""
       from . import entropy
       return entropy.bond_entropy(self,wf,i,j)
+  def get_entropy(self,wf,b=1):
+      """Return the entanglement entropy of a bond"""
+      from . import entropy
+      return entropy.compute_entropy(self,wf,b=b)
+  def get_entanglement_profile(self,wf,**kwargs):
+      """Return the entanglement of all the bonds"""
+      from . import entropy
+      return entropy.entanglement_profile(self,wf,**kwargs)
+  def get_mutual_information(self,**kwargs):
+      """Return the site entropies and the mutual information matrix"""
+      from . import entropy
+      return entropy.mutual_information(self,**kwargs)
   def get_site_entropy(self,wf,b):
       """Return the entanglement entropy of a site"""
       from . import entropy
@@ -333,6 +366,9 @@ class Many_Body_Chain():
       elif mode=="ED": 
           return self.get_ED_obj().get_excited_states(**kwargs) # ED
       else: raise
+  def get_excited_matrix_elements(self,ops,**kwargs):
+      """Return the excited energies and the tensor <i|ops[k]|j>"""
+      return excited.get_excited_matrix_elements(self,ops,**kwargs)
   def get_gap(self,**kwargs):
     """Return the gap"""
     es = self.get_excited(n=2,**kwargs)
@@ -407,6 +443,30 @@ class Many_Body_Chain():
       """
       from . import timedependent
       return timedependent.evolution(self,**kwargs)
+  def evolution_DC_many(self,A,Bs,**kwargs):
+      """
+      Compute the correlators of A with all the operators in Bs,
+      with a single time evolution
+      """
+      from . import timedependent
+      return timedependent.evolution_DC_many(self,A,Bs,**kwargs)
+  def get_thermal(self,**kwargs):
+      """
+      Compute thermal properties with the purification
+      """
+      from . import thermal
+      return thermal.get_thermal(self,**kwargs)
+  def get_otoc(self,**kwargs):
+      """
+      Compute OTOCs with the operator evolved in the Heisenberg picture
+      """
+      return timedependent.get_otoc(self,**kwargs)
+  def measure_local(self,**kwargs):
+      """
+      Compute local observables in all the sites, in a single sweep
+      """
+      from . import measure
+      return measure.measure_local(self,**kwargs)
   def get_rdm(self,**kwargs):
       """
       Compute the reduced density matrix
@@ -0,0 +1,27 @@
+# measure local observables in all the sites
+import numpy as np
+
+
+
+def measure_local(self,names=["Sz"],wf=None):
+    """Compute the expectation values of the operators names (as in
+    get_operator) in all the sites, in a single sweep of the state wf
+    (the ground state if None). Returns an array (operators,sites)"""
+    if type(names)==str: names = [names]
+    task = {"measure_local":"true",
+            "measure_local_noperators":str(len(names)),
+            }
+    for (k,n) in enumerate(names): task["measure_local_operator_"+str(k)] = n
+    if wf is None: # use the ground state
+        self.get_gs() # compute ground state
+        task["measure_local_gs"] = "true"
+    else: self.execute(lambda: wf.write(name="wavefunction.mps"))
+    self.task = task # assign tasks
+    self.write_task()
+    self.write_hamiltonian() # write the Hamiltonian to a file
+    self.run() # perform the calculation
+    def read(): # read the binary file
+        f = open("MEASURE_LOCAL.BIN","rb")
+        (nop,n) = np.fromfile(f,dtype=np.int32,count=2)
+        return np.fromfile(f,dtype=np.complex128).reshape((nop,n))
+    return self.execute(read)
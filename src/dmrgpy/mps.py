@@ -58,10 +58,15 @@ class MPS():
         open(path+"/sites.sites","wb").write(self.sites) # write the sites
     def get_entropy(self,b=None):
         """Compute entanglement entropy in a bond"""
-        if b is None: # compute all 
-            return np.mean([self.get_entropy(i) for i in range(1,self.MBO.ns)])
+        if b is None: # compute all, in a single sweep
+            return np.mean(self.get_entanglement_profile()["entropy"])
         if self.MBO is not None: return self.MBO.get_entropy(self,b=b)
         else: raise
+    def get_entanglement_profile(self,**kwargs):
+        """Compute the entanglement of all the bonds"""
+        if self.MBO is not None: 
+            return self.MBO.get_entanglement_profile(self,**kwargs)
+        else: raise
     def get_site_entropy(self,i):
         if self.MBO is not None: return self.MBO.get_site_entropy(self,i)
         else: raise # not implemented
@@ -20,13 +20,26 @@ def exponential(self,h,wf,mode="DMRG",**kwargs):
 def exponential_dmrg(self,h,wfa,dt=1.0,nt=1000,nt0=None):
     """Compute the exponential of a wavefunction"""
     if not h.is_hermitian(): raise
-    if nt0 is None: nt0 = int(h.get_bandwidth(self)*nt)
+    # with TDVP or Krylov, the steps are chosen by their error
+    adaptive = self.tevol_method in ["tdvp","tdvp1","krylov"]
+    # TEBD is only for real time, so the other methods use the MPO
+    if adaptive: method = self.tevol_method
+    else: method = "mpo"
+    if nt0 is None: 
+        if adaptive: nt0 = 1 # initial number of steps
+        else: nt0 = int(h.get_bandwidth(self)*nt)
     task = {"exponential_eMwf":"true",
             "tevol_dt_real":str(-dt.real),
             "tevol_dt_imag":str(dt.imag),
             "tevol_n":str(int(nt0)),
+            "tevol_method":method,
+            "tevol_adaptive":adaptive,
+            "tevol_dt_tol":str(self.tevol_dt_tol),
+            "tevol_fit_td":self.fit_td,
             }
     if self.tevol_custom_exp: task["tevol_custom_exp"] = "true"
+    from .timedependent import expmpo_task
+    task.update(expmpo_task(self)) # MPO of the time step
     self.task = task # override tasks
     self.execute(lambda: wfa.write(name="input_wavefunction.mps")) # copy WF
     self.execute(lambda: h.write(name="hamiltonian.in"))
@@ -78,6 +91,27 @@ def overlap_aMb_dmrg(self,wf1,A,wf2):
     return m[0] + 1j*m[1]
 
 
+def gram_matrix(self,wfs,A=None):
+    """Compute the matrix of overlaps <wfs[i]|wfs[j]>, or <wfs[i]|A|wfs[j]>
+    if an operator is given, in a single run"""
+    n = len(wfs) # number of wavefunctions
+    task = {"gram_matrix":"true","gram_nwf":str(n),
+            "gram_operator":str(A is not None).lower()}
+    self.task = task # override tasks
+    for i in range(n):
+        self.execute(lambda: wfs[i].write(name="gram_wf_"+str(i)+".mps"))
+    if A is not None:
+        from .multioperator import obj2MO
+        A = obj2MO(A) # convert to a MO
+        self.execute(lambda: A.write(name="gram_multioperator.in"))
+    self.execute(lambda: self.run()) # run calculation
+    m = self.execute(lambda : np.genfromtxt("GRAM.OUT")) # read
+    m = np.atleast_2d(m)
+    out = np.zeros((n,n),dtype=np.complex128)
+    out[m[:,0].astype(int),m[:,1].astype(int)] = m[:,2] + 1j*m[:,3]
+    return out
+
+
 def applyoperator(self,A,wf,**kwargs):
     if type(wf)==mps.MPS: mode="DMRG"
     elif type(wf)==np.ndarray: mode="ED"
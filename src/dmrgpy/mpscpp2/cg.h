@@ -1,63 +1,79 @@
-// conjugate gradient method to solve A*x = b for MPS
+// conjugate gradient methods for MPS, for Hermitian and positive
+// definite problems
 
-static auto solveAxb=[](auto A, auto b )
+
+
+// apply (H-w)**2 +d**2 to an MPS, H^2 is never built as an MPO
+// returns the result and H*p, so that it can be reused
+
+static auto applyHwd=[](MPO const& H, double w, double d, MPS const& p,
+		Args const& args)
+{
+   auto Hp = exactApplyMPO(H,p,args) ; // Apply H*p
+   auto H2p = exactApplyMPO(H,Hp,args) ; // Apply H^2*p
+   auto AP = sum(H2p,-2*w*Hp,args) ; // Add first contribution
+   AP = sum(AP,(w*w+d*d)*p,args) ; // add last contribution
+   return std::make_pair(AP,Hp) ;
+};
+
+
+
+
+// preconditioned conjugate gradient method to solve
+// [(H-w)**2 +d**2]*x = b for MPS
+// prec is a function returning an approximation to [(H-w)**2 +d**2]^-1 r,
+// the Polak-Ribiere form of beta allows it to change between iterations
+// returns x and H*x, the latter accumulated from the H*p of each step
+
+static auto pcgHwdxb=[](MPO const& H, double w, double d, MPS const& b,
+		double tol, int max_it, Args const& args, auto prec)
 {
-   double TOLERANCE = 1.0e-10;
    auto X = b*0.; // initialize
+   auto HX = b*0.; // initialize H*x
    auto R = b;
-   auto P = R;
-   int maxm = get_int_value("maxm") ; // bond dimension for KPM
-   auto cutoff = get_float_value("cutoff") ; // cutoff for KPM
-   int k = 0; // counter
-   auto pp = {"Maxm",maxm,"Cutoff",cutoff} ; // DMRG parameters
-   auto n = 100 ; // maximum number of iterations
-   while ( k < n )
+   auto Z = prec(R); // preconditioned residual
+   auto P = Z;
+   auto rz = real(overlapC(Z,R)) ;
+   auto nb = sqrt(real(overlapC(b,b))) ; // norm of b
+   for (int k=0;k<max_it;k++)
    {
-      auto Rold = R;   
-      auto AP = exactApplyMPO(P,A,pp) ;
-      double alpha = overlap( R, R ) / max(overlap( P, AP ), NEARZERO );
-      X = sum( X, alpha*P,pp );   
-      R = sum( R, -alpha*AP,pp );  
-      if ( overlap( R,R ) < TOLERANCE ) break; 
-      double beta = overlap( R, R ) / max(overlap( Rold, Rold ), NEARZERO );
-      P = vectorCombination( 1.0, R, beta, P );
-      k++;
+      auto APHP = applyHwd(H,w,d,P,args) ; // A*p and H*p
+      double alpha = rz / real(overlapC(P,APHP.first)) ;
+      X = sum( X, alpha*P, args );
+      HX = sum( HX, alpha*APHP.second, args ); // reuse H*p
+      auto Rnew = sum( R, -alpha*APHP.first, args );
+      auto res = sqrt(real(overlapC(Rnew,Rnew)))/nb ; // relative residual
+      if ( res < tol ) {
+        cout << "CG converged in " << k+1 << " iterations" << endl;
+        break;
+      } ;
+      auto Znew = prec(Rnew);
+      auto rznew = real(overlapC(Znew,Rnew)) ;
+      double beta = (rznew - real(overlapC(Znew,R))) / rz ;
+      P = sum( Znew, beta*P, args );
+      R = Rnew ;
+      rz = rznew ;
    }
-   return X;
+   return std::make_pair(X,HX);
 };
 
 
 
 
 // conjugate gradient method to solve [(H-w)**2 +d**2]*x = b for MPS
+// with an optional preconditioner, given by prec_nit plain CG
+// iterations at the (small) bond dimension prec_maxm
 
-static auto solveHwdxb=[](auto H, auto w, auto d, auto b )
+static auto solveHwdxb=[](MPO const& H, double w, double d, MPS const& b,
+		double tol, int max_it, int prec_nit, int prec_maxm,
+		Args const& args)
 {
-   double TOLERANCE = 1.0e-10;
-   auto X = b*0.; // initialize
-   auto R = b;
-   auto P = R;
-   int maxm = get_int_value("maxm") ; // bond dimension for KPM
-   auto cutoff = get_float_value("cutoff") ; // cutoff for KPM
-   int k = 0; // counter
-   auto pp = {"Maxm",maxm,"Cutoff",cutoff} ; // DMRG parameters
-   auto n = 100 ; // maximum number of iterations
-   while ( k < n )
-   {
-      auto Rold = R;   
-// compute A*x
-      auto Hx = exactApplyMPO(P,H,pp) ; // Apply H*x
-      auto H2x = exactApplyMPO(Hx,H,pp) ; // Apply H^2*x
-      auto AP = sum(H2x,-2*w*Hx,dd) ; // Add first contribution
-      AP = sum(AP,(w**2+d**2)*P) ; // add last contribution
-      double alpha = overlap( R, R ) / max(overlap( P, AP ), NEARZERO );
-      X = sum( X, alpha*P,pp );   
-      R = sum( R, -alpha*AP,pp );  
-      if ( overlap( R,R ) < TOLERANCE ) break; 
-      double beta = overlap( R, R ) / max(overlap( Rold, Rold ), NEARZERO );
-      P = vectorCombination( 1.0, R, beta, P );
-      k++;
-   }
-   return X;
-}
-;
+   auto noprec = [](MPS const& r) { return r; } ; // no preconditioner
+   if (prec_nit<1) return pcgHwdxb(H,w,d,b,tol,max_it,args,noprec) ;
+   auto pargs = Args({"Maxm",prec_maxm,
+		   "Cutoff",args.getReal("Cutoff",1E-12)}); // low bond dimension
+   auto prec = [&](MPS const& r) {
+     return pcgHwdxb(H,w,d,r,0.0,prec_nit,pargs,noprec).first ;
+   } ;
+   return pcgHwdxb(H,w,d,b,tol,max_it,args,prec) ;
+};
@@ -8,3 +8,115 @@ static auto compute_overlap=[]() {
   myfile << std::setprecision(20) << imag(out) << endl;  // compute
 }
 ;
+
+
+// true if two tensors have the same indices and the same entries
+static auto same_tensor=[](ITensor const& A, ITensor const& B) {
+  if (A.r()!=B.r()) return false ;
+  for (auto const& i : A.inds()) if (!hasindex(B,i)) return false ;
+  return norm(A-B) <= 1e-14*norm(A) ;
+} ;
+
+
+
+// matrix elements <wfs[i]|ops[k]|wfs[j]> for a list of (k,i,j), with
+// k<0 for the plain overlap <wfs[i]|wfs[j]>, returned in the same order
+// the left environments are built site by site for all the elements at
+// once, on several threads, and states whose first tensors are the same
+// (the same prefix) share them, so each distinct combination of operator
+// and prefixes is only contracted once
+// the tensors are only the same if they also have the same link indices,
+// so this only helps for copies of a state (or MPS that were built from
+// the same one), independently computed MPS never share a prefix; for
+// them the comparison stops at the first site, where their links differ
+static auto matrix_elements=[](std::vector<MPS> const& wfs,
+		std::vector<MPO> const& ops,
+		std::vector<std::array<int,3>> const& elements) {
+  int n = wfs.size() ;
+  int N = wfs.at(0).N() ;
+  auto cls = std::vector<int>(n,0) ; // class of the prefix of each state
+  auto envs = std::map<std::array<int,3>,ITensor>() ; // environments
+  int ncontractions = 0 ;
+  for (int b=1;b<=N;b++) {
+    // the classes of the prefix up to b refine those up to b-1
+    auto ncls = std::vector<int>(n) ;
+    auto reps = std::vector<int>() ; // a state of each class
+    auto parent = std::vector<int>() ; // class of each new class in b-1
+    for (int i=0;i<n;i++) {
+      ncls.at(i) = -1 ;
+      for (size_t c=0;c<reps.size();c++) {
+        int r = reps.at(c) ;
+        if (cls.at(r)==cls.at(i) && same_tensor(wfs.at(i).A(b),wfs.at(r).A(b))) {
+          ncls.at(i) = c ; break ;
+	} ;
+      } ;
+      if (ncls.at(i)<0) { // new class
+        ncls.at(i) = reps.size() ;
+        reps.push_back(i) ;
+        parent.push_back(cls.at(i)) ;
+      } ;
+    } ;
+    auto keys = std::vector<std::array<int,3>>() ; // operator and classes
+    for (auto const& e : elements) {
+      auto k = std::array<int,3>({e[0],ncls.at(e[1]),ncls.at(e[2])}) ;
+      if (std::find(keys.begin(),keys.end(),k)==keys.end()) keys.push_back(k);
+    } ;
+    auto nenvs = std::vector<ITensor>(keys.size()) ;
+    parallel_for(keys.size(),get_nthreads(),[&](int k) {
+      auto op = keys.at(k)[0], ci = keys.at(k)[1], cj = keys.at(k)[2] ;
+      auto const& A = wfs.at(reps.at(ci)).A(b) ; // bra
+      auto const& B = wfs.at(reps.at(cj)).A(b) ; // ket
+      ITensor E ;
+      if (b>1) E = envs.at({op,parent.at(ci),parent.at(cj)})*B ;
+      else E = B ;
+      if (op>=0) E = E*ops.at(op).A(b)*dag(prime(A)) ;
+      else E = E*dag(prime(A,Link)) ;
+      nenvs.at(k) = E ;
+    }) ;
+    envs.clear() ;
+    for (size_t k=0;k<keys.size();k++) envs[keys.at(k)] = nenvs.at(k) ;
+    ncontractions += keys.size() ;
+    cls = ncls ;
+  } ;
+  cout << "Matrix elements " << elements.size() << " computed with "
+	  << ncontractions << " contractions, instead of "
+	  << N*elements.size() << endl ;
+  auto out = std::vector<Cplx>() ;
+  for (auto const& e : elements)
+    out.push_back(envs.at({e[0],cls.at(e[1]),cls.at(e[2])}).cplx()) ;
+  return out ;
+} ;
+
+
+
+// matrix of overlaps <wf_i|wf_j> (or <wf_i|O|wf_j> if gram_operator)
+// of the gram_nwf wavefunctions gram_wf_i.mps, written in GRAM.OUT as
+// lines i j real imag
+// without operator only the pairs i<=j are computed, and the pairs i>j
+// follow from the hermiticity
+static auto gram_matrix=[]() {
+  int n = get_int_value("gram_nwf") ; // number of wavefunctions
+  auto wfs = std::vector<MPS>() ;
+  for (int i=0;i<n;i++) wfs.push_back(read_wf("gram_wf_"+std::to_string(i)+".mps")) ;
+  bool op = get_bool("gram_operator") ; // with an operator
+  auto ops = std::vector<MPO>() ;
+  if (op) ops.push_back(get_mpo_operator("gram_multioperator.in")) ;
+  auto elements = std::vector<std::array<int,3>>() ; // pairs computed
+  for (int i=0;i<n;i++) for (int j=(op ? 0 : i);j<n;j++)
+    elements.push_back({op ? 0 : -1,i,j}) ;
+  auto gs = matrix_elements(wfs,ops,elements) ;
+  auto G = std::vector<std::vector<Cplx>>(n,std::vector<Cplx>(n)) ;
+  for (size_t k=0;k<elements.size();k++) {
+    int i = elements.at(k)[1], j = elements.at(k)[2] ;
+    G.at(i).at(j) = gs.at(k) ;
+    if (!op) G.at(j).at(i) = conj(gs.at(k)) ; // hermiticity
+  } ;
+  ofstream myfile;
+  myfile.open("GRAM.OUT");
+  for (int i=0;i<n;i++) for (int j=0;j<n;j++) {
+    myfile << std::setprecision(20) << i << "  " << j << "  "
+	    << real(G.at(i).at(j)) << "  " << imag(G.at(i).at(j)) << endl ;
+  } ;
+  myfile.close() ;
+}
+;
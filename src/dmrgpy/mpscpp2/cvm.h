@@ -1,4 +1,6 @@
 
+#include"ddmrg.h" // local correction vector solver
+#include"dyncorr.h" // correction vector with conjugate gradient
 
 MPS conjMPS(MPS psi){
     auto tmp = psi*1.;
@@ -9,10 +11,10 @@ MPS conjMPS(MPS psi){
 }
 
 
-// CVM solver
-MPS bicstab(MPO A, MPS b, double tol, int max_it, Args const& args){
+// CVM solver, starting from the initial guess x0
+MPS bicstab(MPO A, MPS b, MPS x0, double tol, int max_it, Args const& args){
 
-    MPS x = b;
+    MPS x = x0;
     MPS r_old = sum(b, -1 * exactApplyMPO(A, x, args));
     MPS r_new;
     MPS r_ = r_old;
@@ -26,6 +28,10 @@ MPS bicstab(MPO A, MPS b, double tol, int max_it, Args const& args){
     double res;
     int k = 0;
 
+    // nothing to do if the initial guess is already converged
+    res = sqrt(abs(overlapC(conjMPS(r_old), r_old).real()));
+    if(res <= tol) return x;
+
     while(k < max_it){
 
         Ap = exactApplyMPO(A, p, args);
@@ -52,6 +58,26 @@ MPS bicstab(MPO A, MPS b, double tol, int max_it, Args const& args){
     return x;
 }
 
+// CVM solver, starting from x = b
+MPS bicstab(MPO A, MPS b, double tol, int max_it, Args const& args){
+    return bicstab(A, b, b, tol, max_it, args);
+}
+
+// solve (z-H)|x> = |b> starting from x0, either with BiCGStab
+// on the whole MPS, with local sweeps (solver "ddmrg"), or with
+// CG for the squared problem (solver "cg", which starts from zero)
+static auto correction_vector=[](std::string solver, MPO H, MPO Id, MPS b,
+		MPS x0, std::complex<double> z, double tol, int max_it,
+		int nsweeps, Args const& args) {
+
+    if(solver == "ddmrg")
+        return correction_vector_dmrg(H, b, x0, z, tol, max_it, nsweeps, args);
+    if(solver == "cg")
+        return correction_vector_cg(H, b, z, tol, max_it, args);
+    auto A = sum(z * Id, -1. * H, args);
+    return bicstab(A, b, x0, tol, max_it, args);
+};
+
 // main CVM function
 static auto spectral_function=[](MPS psi, MPO H, MPO S1, MPO S2, double omega,
 		double eta, double energy, double tol, int max_it,
@@ -59,9 +85,9 @@ static auto spectral_function=[](MPS psi, MPO H, MPO S1, MPO S2, double omega,
 
     auto args = Args({"Maxm", maxm, "Cutoff", cut});
     const std::complex<double> z(omega + energy, eta);
-    auto A = sum(z * Iden(sites), -1. * H, args);
     auto b =  exactApplyMPO(S2, psi, args);
-    auto x = bicstab(A, b, tol, max_it, args);
+    auto x = correction_vector(get_str("cvm_solver"), H, Iden(sites), b, b,
+		    z, tol, max_it, get_int_value("nsweeps"), args);
     std::complex<double> G = overlapC(psi, S1, x);
 
     return -G.imag() / M_PI;
@@ -30,3 +30,64 @@ static auto cvm_dynamical_correlator=[]() {
                        << std::setprecision(8)<< imag(z) << endl;
   filecvm.close(); // close file
 } ;
+
+
+
+// read the list of frequencies for the CVM
+static auto read_cvm_energies=[]() {
+  ifstream efile; // file to read
+  efile.open("cvm_energies.in"); // file with the energies
+  int ne ; // number of energies
+  efile >> ne; // read the number of energies
+  auto es = std::vector<double>(ne) ; // storage
+  for (int i=0;i<ne;i++) efile >> es.at(i) ; // read energy
+  efile.close() ;
+  return es ;
+} ;
+
+
+
+// compute the dynamical correlator with CVM for a whole grid of
+// frequencies, sharing the ground state and A|GS>, and using the
+// solution at the previous frequency as initial guess for the next one
+static auto cvm_dynamical_correlator_grid=[]() {
+  auto sites = get_sites();
+  // now get the operators
+  auto A1 = get_mpo_operator("dc_multioperator_i.in");
+  auto A2 = get_mpo_operator("dc_multioperator_j.in");
+  auto H = get_hamiltonian(sites) ; // get the ampo for the Hamiltonian
+  auto psi = get_gs() ; // get the ground state
+  int maxm = get_int_value("maxm") ; // bond dimension
+  int max_it = get_int_value("cvm_nit") ; // number of iterations
+  auto cutoff = get_float_value("cutoff") ; // cutoff of DMRG
+  auto delta = get_float_value("cvm_delta") ; // delta
+  auto e0 = get_float_value("cvm_e0") ; // GS energy
+  auto tol = get_float_value("cvm_tol") ; // tolerance
+  auto solver = get_str("cvm_solver") ; // solver for each frequency
+  int nsweeps = get_int_value("nsweeps") ; // sweeps for the ddmrg solver
+  int nthreads = get_nthreads() ; // number of threads
+  auto es = read_cvm_energies() ; // frequencies
+  int ne = es.size() ; // number of frequencies
+  auto args = Args({"Maxm", maxm, "Cutoff", cutoff}); // MPS arguments
+  auto Id = Iden(sites) ; // identity
+  auto b = exactApplyMPO(A2, psi, args); // A|GS>, computed only once
+  auto gs = std::vector<std::complex<double>>(ne) ; // storage
+  // each thread takes a contiguous block of frequencies
+  parallel_blocks(ne,nthreads,[&](int i0, int i1) {
+    auto x = b ; // initial guess for the first frequency of the block
+    for (int i=i0;i<i1;i++) {
+      const std::complex<double> z(es.at(i) + e0, delta);
+      x = correction_vector(solver, H, Id, b, x, z, tol, max_it,
+		      nsweeps, args); // warm start
+      gs.at(i) = overlapC(psi, A1, x); // store the correlator
+    } ;
+  }) ;
+  ofstream filecvm;
+  filecvm.open("CVM_GRID.OUT"); // open file
+  for (int i=0;i<ne;i++) {
+    filecvm << std::setprecision(16) << es.at(i) << "  "
+            << std::setprecision(16) << real(gs.at(i)) << "  "
+            << std::setprecision(16) << imag(gs.at(i)) << endl;
+  } ;
+  filecvm.close(); // close file
+} ;
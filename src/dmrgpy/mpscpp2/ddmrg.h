@@ -0,0 +1,94 @@
+// correction vector with a DMRG-like sweep (dynamical DMRG)
+// the equation (z-H)|x> = |b> is solved locally on each bond,
+// using the environments of H and BiCGStab for the two-site problem
+// (the gmres of ITensor v2 is not reliable for complex problems)
+
+
+// two-site operator z-H
+class CVMLocalOp {
+    LocalMPO<ITensor> const& PH_; // environments of the Hamiltonian
+    Cplx z_; // complex frequency
+    public:
+    CVMLocalOp(LocalMPO<ITensor> const& PH, Cplx z) : PH_(PH), z_(z) { }
+    void product(ITensor const& phi, ITensor& phip) const {
+        PH_.product(phi,phip); // H|phi>
+        phip = z_*phi - phip; // (z-H)|phi>
+    }
+    long size() const { return PH_.size(); }
+};
+
+
+
+// BiCGStab for the two-site problem A*x = b, x is the initial guess
+static auto local_bicgstab=[](CVMLocalOp const& A, ITensor const& b,
+		ITensor& x, double tol, int max_it) {
+  auto dotc = [](ITensor const& u, ITensor const& v) {
+    return (dag(u)*v).cplx() ; } ; // <u|v>
+  ITensor Ax ;
+  A.product(x,Ax) ;
+  auto r = b - Ax ; // residual
+  auto rh = r ; // shadow residual
+  auto nb = norm(b) ; // norm of the right hand side
+  if (nb==0.0 or norm(r)<tol*nb) return ; // nothing to do
+  ITensor p, v, s, t ;
+  Cplx rho0 = 1.0, alpha = 1.0, w = 1.0 ;
+  for (int k=0;k<max_it;k++) {
+    auto rho = dotc(rh,r) ;
+    if (k==0) p = r ;
+    else p = r + ((rho/rho0)*(alpha/w))*(p - w*v) ;
+    A.product(p,v) ;
+    alpha = rho/dotc(rh,v) ;
+    s = r - alpha*v ;
+    if (norm(s)<tol*nb) { x += alpha*p ; return ; } ; // converged
+    A.product(s,t) ;
+    w = dotc(t,s)/dotc(t,t) ;
+    x += alpha*p + w*s ;
+    r = s - w*t ;
+    if (norm(r)<tol*nb) return ; // converged
+    rho0 = rho ;
+  } ;
+} ;
+
+
+
+// add site j to an environment of <x|b>
+static auto cvm_env=[](ITensor const& E, MPS const& b, MPS const& x, int j) {
+  auto out = b.A(j)*dag(prime(x.A(j),Link)) ; // links of x are primed
+  if (E) out *= E ; // previous sites
+  return out ;
+} ;
+
+
+
+// solve (z-H)|x> = |b> by sweeping, starting from x0
+static auto correction_vector_dmrg=[](MPO const& H, MPS const& b,
+		MPS const& x0, Cplx z, double tol, int max_it, int nsweeps,
+		Args const& args) {
+  auto x = x0 ; // initial guess
+  int N = x.N() ; // number of sites
+  x.position(1) ; // orthogonality center in the first site
+  auto LB = std::vector<ITensor>(N+2) ; // left environments of <x|b>
+  auto RB = std::vector<ITensor>(N+2) ; // right environments of <x|b>
+  for (int j=N;j>2;j--) RB.at(j) = cvm_env(RB.at(j+1),b,x,j) ;
+  LocalMPO<ITensor> PH(H,args); // environments of H
+  auto c = overlapC(b,x) ; // to check convergence
+  for (int sw=1;sw<=nsweeps;sw++) {
+    for(int j = 1, ha = 1; ha <= 2; sweepnext(j,ha,N)) {
+      PH.position(j,x); // environments of H in this bond
+      auto bb = b.A(j)*b.A(j+1) ; // right hand side in this bond
+      if (LB.at(j-1)) bb *= LB.at(j-1) ; // project in the left block
+      if (RB.at(j+2)) bb *= RB.at(j+2) ; // project in the right block
+      bb.noprime(Link) ; // same indexes as x
+      auto phi = x.A(j)*x.A(j+1) ; // initial guess in this bond
+      local_bicgstab(CVMLocalOp(PH,z),bb,phi,tol,max_it) ; // local problem
+      x.svdBond(j,phi,(ha==1?Fromleft:Fromright),PH,args) ; // truncate
+      if (ha==1) LB.at(j) = cvm_env(LB.at(j-1),b,x,j) ; // going right
+      else RB.at(j+1) = cvm_env(RB.at(j+2),b,x,j+1) ; // going left
+    } ;
+    auto cn = overlapC(b,x) ; // new overlap
+    cout << "DDMRG sweep " << sw << ", <b|x> = " << cn << endl ;
+    if (abs(cn-c)<tol) break ; // converged
+    c = cn ; // store
+  } ;
+  return x ;
+} ;
@@ -22,3 +22,41 @@ static auto get_moments_distribution=[]()
   return 0 ;
 } ;
 
+
+
+
+
+// compute the moments of the distributions of several operators in the
+// same state, each Chebyshev recursion running on its own thread
+// the operators are in kpm_distribution_multioperator_k.in, and the
+// moments are written in binary to KPM_MOMENTS_DISTRIBUTION.BIN as
+// two int32 (operators, moments) and then the complex moments
+
+static auto get_moments_distribution_batch=[]()
+{
+  auto sites = get_sites(); // Get the different sites
+  auto n = get_int_value("kpm_num_polynomials") ; // number of polynomials
+  int nop = get_int_value("kpm_distribution_noperators") ; // operators
+  int kpmmaxm = get_int_value("kpmmaxm") ; // bond dimension for KPM
+  auto kpmcutoff = get_float_value("kpm_cutoff") ; // cutoff for KPM
+  int nthreads = get_nthreads() ; // number of threads
+  auto args = Args({"Maxm",kpmmaxm,"Cutoff",kpmcutoff}) ;
+  auto psi = get_gs() ; // get the ground state, shared by all
+  auto ms = std::vector<MPO>() ; // operators
+  for (int k=0;k<nop;k++)
+    ms.push_back(get_mpo_operator("kpm_distribution_multioperator_"
+			    +std::to_string(k)+".in")) ;
+  auto mus = std::vector<std::vector<std::complex<double>>>(nop) ; // moments
+  parallel_for(nop,nthreads,[&](int k) {
+    auto v = psi ; // own copy for this thread
+    mus.at(k) = chebyshev_moments_vv(ms.at(k),v,n,args) ;
+  }) ;
+  ofstream myfile;
+  myfile.open("KPM_MOMENTS_DISTRIBUTION.BIN",ios::out | ios::binary);
+  int32_t header[2] = {nop, n+2} ; // dimensions
+  myfile.write((char*)header,sizeof(header)) ;
+  for (auto const& muk : mus) // complex<double> is stored as (re,im)
+    myfile.write((char*)muk.data(),muk.size()*sizeof(std::complex<double>)) ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
@@ -13,12 +13,20 @@ int dynamical_correlator_excited() {
 	auto A1 = get_mpo_operator("dc_multioperator_i.in");
 	auto A2 = get_mpo_operator("dc_multioperator_j.in");
 	auto psi0 = get_gs(); // ground state
+	// <n|A1|0> and <n|A2|0> for all the excited states at once
+	wfs.push_back(psi0) ; // the ket is the last one
+	auto elements = std::vector<std::array<int,3>>() ;
+	for(int i=1;i<nexcited;i++) {
+		elements.push_back({0,i,nexcited}) ;
+		elements.push_back({1,i,nexcited}) ;
+	}
+	auto cs = matrix_elements(wfs,{A1,A2},elements) ;
 	// open files
 	ofstream fileoverlap;
         fileoverlap.open("EXCITED_OVERLAPS.OUT"); // open file
 	for(int i=1;i<nexcited;i++) {
-		auto c1 = overlapC(wfs.at(i),A1,psi0); // compute overlap
-		auto c2 = overlapC(wfs.at(i),A2,psi0); // compute overlap
+		auto c1 = cs.at(2*(i-1)) ; // <i|A1|0>
+		auto c2 = cs.at(2*(i-1)+1) ; // <i|A2|0>
 		fileoverlap << std::setprecision(20) << real(c1) << "  "; 
 		fileoverlap << std::setprecision(20) << imag(c1) << "  "; 
 		fileoverlap << std::setprecision(20) << real(c2) << "  "; 
@@ -29,3 +37,32 @@ int dynamical_correlator_excited() {
 	// now that we have the matrix elements, compute the correlator
 	return 0; // return
 }
+
+
+
+// matrix elements <n|A_k|m> of the operators excited_me_multioperator_k.in
+// (k<excited_me_noperators) between all the excited states, for spectra
+// in the Lehmann representation, with the energies in EXCITED.OUT
+// the tensor is written in binary to EXCITED_MATRIX_ELEMENTS.BIN as two
+// int32 (operators, states) and then the complex elements, with the
+// index of the ket running fastest
+static auto excited_matrix_elements=[]() {
+  auto wfs = get_excited(); // get excited states
+  int n = wfs.size() ;
+  int nop = get_int_value("excited_me_noperators") ; // number of operators
+  auto ops = std::vector<MPO>() ;
+  for (int k=0;k<nop;k++)
+    ops.push_back(get_mpo_operator("excited_me_multioperator_"+
+			    std::to_string(k)+".in")) ;
+  auto elements = std::vector<std::array<int,3>>() ;
+  for (int k=0;k<nop;k++) for (int i=0;i<n;i++) for (int j=0;j<n;j++)
+    elements.push_back({k,i,j}) ;
+  auto cs = matrix_elements(wfs,ops,elements) ;
+  ofstream myfile;
+  myfile.open("EXCITED_MATRIX_ELEMENTS.BIN",ios::out | ios::binary);
+  int32_t header[2] = {nop, n} ; // dimensions
+  myfile.write((char*)header,sizeof(header)) ;
+  myfile.write((char*)cs.data(),cs.size()*sizeof(Cplx)) ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
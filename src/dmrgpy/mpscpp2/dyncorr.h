@@ -2,18 +2,18 @@
 
 #include"cg.h" // conjugate gradient function
 
-static auto dynamical_correlator=[]() {
-  auto sites = get_sites(); // get the sites
-  auto H = get_hamiltonian(sites) ; // get the Hamiltonian
-  auto psi = get_gs() ; // get the ground state
-  // get the two operator
-  auto opi = get_operator(sites,i,get_str("dynamical_correlator_operator_i")) ;
-  auto opj = get_operator(sites,j,get_str("dynamical_correlator_operator_j")) ;
-  auto delta = get_float_value("delta_dynamical_correlator") ; // smearing
-  auto pp = {"Maxm",maxm,"Cutoff",cutoff} ; // DMRG parameters
-  auto wfi =  exactApplyMPO(psi,opj,pp) ; // Apply operator
-  auto v = solveHwdb(H,energy,delta,wfi) ; // get the correction vector
-  // this is not finished
-
+// solve (z-H)|x> = |b> with z = w + i*d, using that
+// (z-H)^-1 = (conj(z)-H) [(H-w)**2 +d**2]^-1
+// the Hermitian positive definite problem is solved with CG
+static auto correction_vector_cg=[](MPO const& H, MPS const& b,
+		std::complex<double> z, double tol, int max_it, Args const& args) {
+  int prec_nit = 0 ; // no preconditioner by default
+  int prec_maxm = get_int_value("maxm") ; // bond dimension
+  if (get_bool("cg_precondition")) {
+    prec_nit = get_int_value("cg_precondition_nit") ; // inner iterations
+    prec_maxm = get_int_value("cg_precondition_maxm") ; // bond dimension
+  } ;
+  auto yHy = solveHwdxb(H,real(z),imag(z),b,tol,max_it,
+		  prec_nit,prec_maxm,args) ; // get y and H*y
+  return sum(conj(z)*yHy.first,-1.0*yHy.second,args) ; // (conj(z)-H)*y
 };
-
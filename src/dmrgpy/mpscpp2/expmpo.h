@@ -0,0 +1,278 @@
+// MPO of the time step exp(-tau*H), built directly from the AutoMPO
+// each term of H is a product of site operators, and the states of the
+// MPO in each bond are the left parts of the terms crossing it, so that
+// in each site H = [[1,C,D],[0,A,B],[0,0,1]], with D the on-site terms,
+// C starting a term, A continuing it and B ending it
+// W1 is the first order MPO 1-tau*H (W^I of Zaletel et al.), and W2
+// (W^II) also has all the products of terms that do not overlap, from
+// the exponential of D, C, B and A with two auxiliary states
+// higher orders are products of W(a_k*tau), with (1+a_k*x) the factors
+// of the Taylor polynomial 1+x+...+x^p/p!, and the error of each order
+// is estimated from the difference with the next one
+
+
+
+// operators of the Hamiltonian in one site, as d x d matrices
+struct ExpMPOSite {
+  int d = 0 ; // dimension of the site
+  std::vector<Cplx> D ; // on-site terms
+  std::map<int,std::vector<Cplx>> C ; // start the state c of the right bond
+  std::map<int,std::vector<Cplx>> B ; // end the state r of the left bond
+  std::map<std::pair<int,int>,std::vector<Cplx>> A ; // from state r to c
+};
+
+
+
+// operators of H in each site, and number of states of each bond
+static auto get_expmpo_sites=[](AutoMPO const& ampo) {
+  auto sites = ampo.sites() ;
+  int N = sites.N() ; // number of sites
+  auto ws = std::vector<ExpMPOSite>(N+1) ;
+  auto states = std::vector<std::map<std::string,int>>(N+1) ; // of each bond
+  auto matrix = [&sites](ITensor const& o, int n) { // d x d matrix
+    Index s = sites(n) ;
+    int d = s.m() ;
+    auto m = std::vector<Cplx>(d*d) ;
+    for (int i=0;i<d;i++) for (int j=0;j<d;j++)
+      m.at(i*d+j) = o.cplx(prime(s)(i+1),s(j+1)) ;
+    return m ;
+  } ;
+  auto add = [](std::vector<Cplx>& a, std::vector<Cplx> const& b, Cplx c) {
+    if (a.empty()) a.assign(b.size(),0.0) ;
+    for (size_t i=0;i<b.size();i++) a.at(i) += c*b.at(i) ;
+  } ;
+  for (int n=1;n<=N;n++) {
+    ws.at(n).d = Index(sites(n)).m() ;
+    ws.at(n).D.assign(ws.at(n).d*ws.at(n).d,0.0) ;
+  } ;
+  for (auto const& t : ampo.terms()) {
+    auto onsite = std::map<int,std::vector<std::string>>() ; // in each site
+    for (auto const& st : t.ops) onsite[st.i].push_back(st.op) ;
+    int i0 = onsite.begin()->first ; // first site
+    int i1 = onsite.rbegin()->first ; // last site
+    // Jordan-Wigner strings as in AutoMPO, the sites with an odd number
+    // of fermionic operators get the local rewrite, and F is added when
+    // the parity of the operators up to the site is odd
+    auto ops = std::map<int,ITensor>() ; // operator in each site
+    auto names = std::map<int,std::string>() ; // and its name
+    bool leftf = false ; // parity of the operators to the left
+    for (int n=i0;n<=i1;n++) {
+      auto p = onsite[n] ;
+      bool sitef = false ; // parity of the operators of this site
+      for (auto const& o : p) if (o.front()=='C') sitef = not sitef ;
+      if (sitef) for (auto& o : p) o = local_fermionic_name(o) ;
+      if (leftf!=sitef) p.push_back("F") ;
+      if (p.empty()) p.push_back("Id") ;
+      for (auto const& o : p) {
+        auto so = site_op(sites,o,n) ;
+        if (ops.count(n)) {
+          ops[n] = multSiteOps(ops[n],so) ;
+          names[n] += "*"+o ;
+        }
+        else { ops[n] = so ; names[n] = o ; } ;
+      } ;
+      leftf = (leftf!=sitef) ;
+    } ;
+    if (i0==i1) { add(ws.at(i0).D,matrix(ops[i0],i0),t.coef) ; continue ; } ;
+    std::string key ; // left part of the term
+    int r = 0 ; // state in the left bond
+    for (int n=i0;n<=i1;n++) {
+      auto m = matrix(ops[n],n) ;
+      if (n==i1) { add(ws.at(n).B[r],m,t.coef) ; break ; } ; // end
+      key += " "+names[n]+"_"+std::to_string(n) ;
+      auto& sn = states.at(n) ;
+      if (not sn.count(key)) { int k = sn.size() ; sn[key] = k ; } ; // new
+      int c = sn[key] ; // state in the right bond
+      if (n==i0) ws.at(n).C[c] = m ; // start
+      else ws.at(n).A[std::make_pair(r,c)] = m ; // continue
+      r = c ;
+    } ;
+  } ;
+  auto nstates = std::vector<int>(N+1) ;
+  for (int n=0;n<=N;n++) nstates.at(n) = states.at(n).size() ;
+  return std::make_pair(ws,nstates) ;
+} ;
+
+
+
+// exponential of a dense m x m matrix, with the Taylor series after
+// scaling it, and squaring the result
+static auto dense_expm=[](std::vector<Cplx> M, int m) {
+  auto mult = [m](std::vector<Cplx> const& a, std::vector<Cplx> const& b) {
+    auto c = std::vector<Cplx>(m*m,0.0) ;
+    for (int i=0;i<m;i++) for (int k=0;k<m;k++) {
+      auto aik = a[i*m+k] ;
+      if (aik==0.0) continue ;
+      for (int j=0;j<m;j++) c[i*m+j] += aik*b[k*m+j] ;
+    } ;
+    return c ;
+  } ;
+  double norm = 0.0 ; // maximum row sum
+  for (int i=0;i<m;i++) {
+    double r = 0.0 ;
+    for (int j=0;j<m;j++) r += abs(M[i*m+j]) ;
+    norm = std::max(norm,r) ;
+  } ;
+  int ns = 0 ; // number of squarings
+  while (norm>0.5) { norm /= 2. ; ns++ ; } ;
+  for (auto& x : M) x /= pow(2.0,ns) ;
+  auto E = std::vector<Cplx>(m*m,0.0) ;
+  for (int i=0;i<m;i++) E[i*m+i] = 1.0 ;
+  auto T = E ; // term of the series
+  for (int k=1;k<=30;k++) {
+    T = mult(T,M) ;
+    double tmax = 0.0 ;
+    for (auto& x : T) { x /= Real(k) ; tmax = std::max(tmax,abs(x)) ; } ;
+    for (int i=0;i<m*m;i++) E[i] += T[i] ;
+    if (tmax<1e-18) break ; // converged
+  } ;
+  for (int k=0;k<ns;k++) E = mult(E,E) ;
+  return E ;
+} ;
+
+
+
+// MPO W(tau) ~ exp(-tau*H), W2 if w2 is true and W1 otherwise
+static auto get_expmpo_factor=[](AutoMPO const& ampo,
+		std::pair<std::vector<ExpMPOSite>,std::vector<int>> const& T,
+		Cplx tau, bool w2) {
+  auto sites = ampo.sites() ;
+  int N = sites.N() ; // number of sites
+  auto links = std::vector<Index>(N+1) ;
+  for (int n=0;n<=N;n++)
+    links.at(n) = Index("Wl"+std::to_string(n),T.second.at(n)+1,Link) ;
+  auto W = MPO(sites) ;
+  Cplx s = sqrt(-tau) ; // auxiliary states come with sqrt(-tau)
+  auto build = [&](int n) { // tensor of site n
+    auto const& w = T.first.at(n) ;
+    int d = w.d ;
+    Index si = sites(n) ;
+    auto const& row = links.at(n-1) ;
+    auto const& col = links.at(n) ;
+    auto Wn = ITensor(si,prime(si),row,col) ;
+    // store f*m in the element (r,c), with m a block of a matrix
+    auto put = [&](int r, int c, std::vector<Cplx> const& m, int ld,
+		    int off, Cplx f) {
+      for (int i=0;i<d;i++) for (int j=0;j<d;j++) {
+        auto z = f*m.at((off+i)*ld+j) ;
+        if (z!=0.0) Wn.set(prime(si)(i+1),si(j+1),row(r),col(c),z) ;
+      } ;
+    } ;
+    int nr = T.second.at(n-1), nc = T.second.at(n) ; // number of states
+    if (not w2) { // 1 - tau*H
+      auto D = w.D ;
+      for (auto& x : D) x *= -tau ;
+      for (int i=0;i<d;i++) D.at(i*d+i) += 1.0 ;
+      put(1,1,D,d,0,1.0) ;
+      for (auto const& x : w.C) put(1,x.first+2,x.second,d,0,-tau) ;
+      for (auto const& x : w.B) put(x.first+2,1,x.second,d,0,1.0) ;
+      for (auto const& x : w.A) put(x.first.first+2,x.first.second+2,
+		      x.second,d,0,1.0) ;
+      return Wn ;
+    } ;
+    // exponential with the states 00, r0, 0c and rc, with r the end of a
+    // term in the left bond and c the start of one in the right bond
+    auto zero = std::vector<Cplx>(d*d,0.0) ;
+    auto get = [&zero](auto const& x, auto const& k) -> std::vector<Cplx> const& {
+      auto it = x.find(k) ;
+      if (it==x.end()) return zero ;
+      return it->second ; } ;
+    int m = 4*d ; // dimension of the exponential
+    for (int r=-1;r<nr;r++) for (int c=-1;c<nc;c++) {
+      auto const& Br = get(w.B,r) ;
+      auto const& Cc = get(w.C,c) ;
+      auto const& Arc = get(w.A,std::make_pair(r,c)) ;
+      auto M = std::vector<Cplx>(m*m,0.0) ;
+      auto block = [&](int bt, int bs, std::vector<Cplx> const& o, Cplx f) {
+        for (int i=0;i<d;i++) for (int j=0;j<d;j++)
+          M[(bt*d+i)*m+bs*d+j] += f*o.at(i*d+j) ; } ;
+      for (int b=0;b<4;b++) block(b,b,w.D,s*s) ;
+      block(1,0,Br,s) ; block(3,2,Br,s) ; // end a term
+      block(2,0,Cc,s) ; block(3,1,Cc,s) ; // start a term
+      block(3,0,Arc,1.0) ; // continue a term
+      auto E = dense_expm(M,m) ;
+      if (r<0 and c<0) put(1,1,E,m,0,1.0) ;
+      else if (c<0) put(r+2,1,E,m,d,1.0) ;
+      else if (r<0) put(1,c+2,E,m,2*d,1.0) ;
+      else put(r+2,c+2,E,m,3*d,1.0) ;
+    } ;
+    return Wn ;
+  } ;
+  auto Ws = std::vector<ITensor>(N+1) ;
+  parallel_for(N,get_nthreads(),[&](int k) { Ws.at(k+1) = build(k+1) ; }) ;
+  for (int n=1;n<=N;n++) W.Aref(n) = Ws.at(n) ;
+  W.Aref(1) *= setElt(links.at(0)(1)) ;
+  W.Aref(N) *= setElt(links.at(N)(1)) ;
+  return W ;
+} ;
+
+
+
+// factors a_k of the Taylor polynomial of order p,
+// 1+x+...+x^p/p! = (1+a_1*x)...(1+a_p*x)
+static auto taylor_factors=[](int p) {
+  auto c = std::vector<Cplx>(p+1) ; // monic polynomial, with p!/n! x^n
+  c.at(p) = 1.0 ;
+  for (int n=p-1;n>=0;n--) c.at(n) = c.at(n+1)*Real(n+1) ;
+  auto z = std::vector<Cplx>(p) ; // roots, with Durand-Kerner
+  for (int k=0;k<p;k++) z.at(k) = Real(p)*pow(Cplx(0.4,0.9),k) ;
+  for (int it=0;it<1000;it++) {
+    for (int k=0;k<p;k++) {
+      Cplx v = c.at(p) ; // value of the polynomial
+      for (int n=p-1;n>=0;n--) v = v*z.at(k) + c.at(n) ;
+      Cplx q = 1.0 ; // product with the other roots
+      for (int j=0;j<p;j++) if (j!=k) q *= z.at(k)-z.at(j) ;
+      z.at(k) -= v/q ;
+    } ;
+  } ;
+  auto a = std::vector<Cplx>() ;
+  for (auto const& zk : z) a.push_back(-1.0/zk) ;
+  return a ;
+} ;
+
+
+
+// MPO of exp(-tau*H), with tevol_exp_mpo (W1 or W2, the default) and
+// the order in tau tevol_exp_order, or the lowest order whose error is
+// below tevol_exp_tol if it is given
+// the product of the W is compressed to the bond dimension
+// tevol_exp_maxm, so that larger time steps can be traded for a larger
+// MPO, and with tevol_exp_tol or tevol_exp_error the error of each order
+// is written in EXP_MPO.OUT, together with the bond dimension of the MPO
+// the fermionic operators get the Jordan-Wigner strings of AutoMPO
+static auto get_exp_mpo=[](AutoMPO const& ampo, Cplx tau) {
+  bool w2 = get_str("tevol_exp_mpo")!="W1" ; // type of MPO
+  int order = get_int_value("tevol_exp_order") ; // order in tau
+  auto tol = get_float_value("tevol_exp_tol") ; // error of the MPO
+  int maxm = get_int_value("tevol_exp_maxm") ; // bond dimension
+  auto args = Args("Cutoff",1e-14) ;
+  if (maxm>1) args.add("Maxm",maxm) ; // otherwise no limit
+  auto T = get_expmpo_sites(ampo) ; // operators of H in each site
+  auto product = [&](int p) { // W(a_1 tau)...W(a_p tau)
+    auto as = taylor_factors(p) ;
+    auto U = get_expmpo_factor(ampo,T,as.at(0)*tau,w2) ;
+    for (int k=1;k<p;k++) {
+      MPO X ;
+      nmultMPO(U,get_expmpo_factor(ampo,T,as.at(k)*tau,w2),X,args) ;
+      U = X ;
+    } ;
+    return U ;
+  } ;
+  // without tolerance the error is only estimated if tevol_exp_error
+  if (tol<=0.0 and not get_bool("tevol_exp_error")) return product(order) ;
+  int pmax = order ; // maximum order
+  if (tol>0.0) pmax = 10 ;
+  auto U = product(1) ;
+  ofstream f ;
+  f.open("EXP_MPO.OUT") ;
+  for (int p=1;p<=pmax;p++) {
+    auto U1 = product(p+1) ; // next order
+    auto dU = sum(U,-1.0*U1,args) ;
+    auto err = sqrt(std::abs(real(mpo_trace_product(dU,dU,true)))) ;
+    f << p << "  " << std::setprecision(20) << err << "  " << maxM(U) << endl ;
+    if (tol>0.0 and err<tol) break ; // accurate enough
+    if (p<pmax) U = U1 ; // next order
+  } ;
+  f.close() ;
+  return U ;
+} ;
@@ -1,27 +1,38 @@
 
 
-// return a spinless creation/annhilation operator
+// MPO with bond dimension 1 for a product of site operators, given as
+// a list of (name,site) with the sites starting in 1, the operators in
+// the same site are multiplied in the order of the list
+static auto product_operator= [](auto sites,
+		std::vector<std::pair<std::string,int>> const& ops) {
+        auto W = MPO(sites) ; // identity
+        auto ls = std::vector<ITensor>(sites.N()+1) ; // local operators
+        for (auto const& op : ops) {
+          auto o = site_op(sites,op.first,op.second) ;
+          auto& l = ls.at(op.second) ;
+          if (l) l = multSiteOps(l,o) ; else l = o ;
+        } ;
+        for (int j=1;j<=sites.N();j++)
+          W.Aref(j) = ls.at(j) ? ls.at(j) : site_op(sites,"Id",j) ;
+        putMPOLinks(W) ; // links of dimension 1
+        return W ;
+};
+
+
+
+// list of operators of a spinless creation/annhilation operator
 // with Jordan-Wigner strings
-static auto fermionic_operator_spinless= [](auto sites, int i, auto name) {
-        auto ampo = AutoMPO(sites);  // create MPO
-        if (name=="C") {
-        ampo += 1.0,"A",i+1; // bosonic one
-        }
-        if (name=="Cdag") {
-        ampo += 1.0,"Adag",i+1; // bosonic one
-        }
-        int maxm = get_int_value("maxm") ;
-        auto cutoff = get_float_value("cutoff") ;
-        auto m0 = MPO(ampo) ; // create MPO
-        auto m = MPO(ampo) ; // create MPO
-        for(int j=0;j<i;j++) {
-          auto ampoi = AutoMPO(sites); // temporal one
-          ampoi += 1.0,"F",j+1; // string operator
-          auto mi = MPO(ampoi) ; // create MPO
-          nmultMPO(mi,m0,m,{"Maxm",maxm,"Cutoff",cutoff}) ; // multiply MPO
-          m0 = m ; // reassign for next iteration
-        }
-        return m; // return MPO
+static auto fermionic_string_spinless= [](int i, std::string name) {
+        auto ops = std::vector<std::pair<std::string,int>>() ;
+        for(int j=0;j<i;j++) ops.push_back({"F",j+1}) ; // string operator
+        ops.push_back({name=="C" ? "A" : "Adag",i+1}) ; // bosonic one
+        return ops ;
 };
 
 
+
+// return a spinless creation/annhilation operator
+// with Jordan-Wigner strings
+static auto fermionic_operator_spinless= [](auto sites, int i, auto name) {
+        return product_operator(sites,fermionic_string_spinless(i,name)) ;
+};
@@ -56,3 +56,109 @@ static auto entropy=[](auto psi, int b) {
 
 
 
+
+
+
+// entanglement of all the bonds of wavefunction.mps in a single sweep of
+// the orthogonality center, written in ENTANGLEMENT_PROFILE.OUT as
+// bond, bond dimension, von Neumann entropy and the Renyi entropies of
+// orders entanglement_renyi_k, and the normalized Schmidt spectrum
+// (squared singular values) of each bond in ENTANGLEMENT_SPECTRUM.OUT
+static auto entanglement_profile=[]() {
+  auto psi = read_wf("wavefunction.mps"); 
+  int nr = get_int_value("entanglement_nrenyi") ; // number of orders
+  auto ns = std::vector<double>() ; // orders of the Renyi entropies
+  for (int k=0;k<nr;k++)
+    ns.push_back(get_float_value("entanglement_renyi_"+std::to_string(k))) ;
+  ofstream fp, fs ;
+  fp.open("ENTANGLEMENT_PROFILE.OUT") ;
+  fs.open("ENTANGLEMENT_SPECTRUM.OUT") ;
+  psi.position(1) ;
+  for (int b=1;b<psi.N();b++) { // sweep to the right
+    auto wf = psi.A(b)*psi.A(b+1) ;
+    auto U = psi.A(b) ;
+    ITensor S,V ;
+    auto spectrum = svd(wf,U,S,V,{"Truncate",false}) ;
+    auto ps = spectrum.eigs() ;
+    Real norm = 0.0 ;
+    for (auto p : ps) norm += p ;
+    Real SvN = 0.0 ;
+    for (auto p : ps) if (p/norm > 1E-12) SvN += -(p/norm)*log(p/norm) ;
+    auto m = commonIndex(psi.A(b),psi.A(b+1),Link).m() ; // bond dimension
+    fp << std::setprecision(16) << b << "  " << m << "  " << SvN ;
+    for (auto n : ns) { // S_n = log(sum p^n)/(1-n)
+      if (std::abs(n-1.0)<1e-12) { fp << "  " << SvN ; continue ; } ;
+      Real z = 0.0 ;
+      for (auto p : ps) z += pow(p/norm,n) ;
+      fp << "  " << log(z)/(1.0-n) ;
+    } ;
+    fp << endl ;
+    fs << std::setprecision(16) << b ;
+    for (auto p : ps) fs << "  " << p/norm ;
+    fs << endl ;
+    psi.Aref(b) = U ; // left orthogonal
+    psi.Aref(b+1) = S*V ; // next center
+  } ;
+  fp.close() ;
+  fs.close() ;
+  return 0 ;
+} ;
+
+
+
+// von Neumann entropy of a density matrix with primed bra indices
+static auto dm_entropy=[](ITensor const& rho) {
+  ITensor U,D ;
+  auto spectrum = diagHermitian(rho,U,D,{"Truncate",false}) ;
+  Real S = 0. ;
+  for (auto p : spectrum.eigs()) if (p > 1E-12) S += -p*log(p) ;
+  return S ;
+} ;
+
+
+
+// single site entropies and mutual information I(i,j) = S_i + S_j - S_ij
+// of all the pairs of wavefunction.mps, written in SITE_ENTROPY.OUT and
+// MUTUAL_INFORMATION.OUT (a NxN matrix)
+// for each i the center is moved to i, and the environment with the bra
+// of i open is carried to the right, tracing out the sites in between
+static auto mutual_information=[]() {
+  auto psi = read_wf("wavefunction.mps"); 
+  int N = psi.N() ;
+  psi.position(1) ;
+  psi /= sqrt(real(overlapC(psi,psi))) ; // normalize
+  auto link = [&](int k) { return commonIndex(psi.A(k),psi.A(k+1),Link) ; } ;
+  auto S1 = std::vector<double>(N+1,0.0) ; // single site entropies
+  auto S2 = std::vector<std::vector<double>>(N+1,std::vector<double>(N+1));
+  for (int i=1;i<=N;i++) {
+    psi.position(i) ; // left of i is the identity
+    auto A = psi.A(i) ;
+    S1.at(i) = dm_entropy(A*dag(prime(A,Site))) ;
+    if (i==N) break ;
+    auto E = A*dag(prime(prime(A,Site),link(i))) ; // bra of i open
+    for (int j=i+1;j<=N;j++) {
+      auto B = psi.A(j) ;
+      auto Bd = prime(prime(B,Site),link(j-1)) ; // right of j contracted
+      S2.at(i).at(j) = dm_entropy(E*B*dag(Bd)) ;
+      if (j==N) break ;
+      E *= B ; // trace out site j
+      E *= dag(prime(prime(B,link(j-1)),link(j))) ;
+    } ;
+  } ;
+  ofstream fs, fi ;
+  fs.open("SITE_ENTROPY.OUT") ;
+  fi.open("MUTUAL_INFORMATION.OUT") ;
+  for (int i=1;i<=N;i++) {
+    fs << std::setprecision(16) << i-1 << "  " << S1.at(i) << endl ;
+    for (int j=1;j<=N;j++) {
+      double I = 0.0 ;
+      if (i<j) I = S1.at(i) + S1.at(j) - S2.at(i).at(j) ;
+      if (i>j) I = S1.at(i) + S1.at(j) - S2.at(j).at(i) ;
+      fi << std::setprecision(16) << I << "  " ;
+    } ;
+    fi << endl ;
+  } ;
+  fs.close() ;
+  fi.close() ;
+  return 0 ;
+} ;
@@ -1,12 +1,15 @@
+// energy variance <H^2>-<H>^2, with <psi|H H|psi> contracted directly
+// in a single sweep with the environment of both MPO, without applying
+// H to psi as a truncated MPS
+static auto energy_variance=[](MPS const& psi, MPO const& H) {
+    auto n = real(overlapC(psi,psi)) ; // norm
+    auto e = real(overlapC(psi,H,psi))/n ; // energy
+    return real(overlapC(psi,H,H,psi))/n - e*e ; // energy fluctuation
+};
+
 
 float get_energy_fluctuation(auto psi1, auto H) {
-    normalize(psi1); // normalize the wavefunction
-    auto psi2 = exactApplyMPO(psi1,H,{"Maxm",get_int_value("maxm"),
-                 "Cutoff",get_float_value("cutoff")}) ;
-    float de;
-    de = overlap(psi1,psi2);
-    de = overlap(psi2,psi2) - de*de; // energy fluctuation
-    return de; // return energy fluctuation
+    return energy_variance(psi1,H); // return energy fluctuation
 };
 
 // orthogonalize vectors
@@ -42,17 +45,27 @@ static auto get_excited=[]() {
   psi1 = MPS(sites) ; // create new wave
   // lagrange multiplier
   float weight = bandwidth(sites,H)*get_float_value("scale_lagrange_excited"); 
+  // a state is accepted when its energy variance is below
+  // excited_variance_tol, otherwise the DMRG is continued, up to
+  // excited_max_attempts times
+  auto tol = get_float_value("excited_variance_tol") ; // 0 accepts all
+  int nattempts = get_int_value("excited_max_attempts") ; // default 1
   for (i=1;i<nexcited;i++)  { 
     // now compute a new excited state
-    // new energy
-    en0 = dmrg(psi1,H,wfs,sweeps,{"Quiet=",true,"Weight=",weight}); 
-    normalize(psi1); // normalize the wavefunction
-    // compute H|psi>
-    // fluctuation in the energy
-//    if (de<1e-2) { // if the fluctuation is small enough
-      wfs.insert(wfs.end(),psi1); // store this wavefunction
-      psi1 = MPS(sites) ; // new random wavefunction
-//    };
+    for (int k=0;k<nattempts;k++) {
+      // new energy
+      en0 = dmrg(psi1,H,wfs,sweeps,{"Quiet=",true,"Weight=",weight}); 
+      normalize(psi1); // normalize the wavefunction
+      // fluctuation in the energy
+      auto de = energy_variance(psi1,H) ;
+      bool accept = (tol<=0.0) or (de<tol) ;
+      cout << "Excited state " << i << ", energy = " << en0
+	   << ", variance = " << de << (accept ? ", accepted" : ", rejected")
+	   << endl ;
+      if (accept) break ; // if the fluctuation is small enough
+    } ;
+    wfs.insert(wfs.end(),psi1); // store this wavefunction
+    psi1 = MPS(sites) ; // new random wavefunction
   } ;
   // write all the excited states in files
   for (i=0;i<nexcited;i++)  { 
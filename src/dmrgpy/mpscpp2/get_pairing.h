@@ -39,8 +39,6 @@ static auto get_pairing_MPO=[](auto sites) {
     auto tr=0.0; // real part
     auto ti=0.0; // imaginary part
     // this function only considers spin independent hoppings
-    int maxm = get_int_value("maxm") ; // bond dimension for KPM
-    float cutoff = get_float_value("cutoff") ; // cutoff for KPM
     for (int i=0;i<nt;++i) {
 //      cout << i << endl ;
       jfile >> j1 >> j2 >> tr >> ti; // get the data
@@ -49,14 +47,13 @@ static auto get_pairing_MPO=[](auto sites) {
 	      auto g = tr + ti*1i; // coupling
 	      auto gd = tr - ti*1i; // coupling
 	      cout << "Pairing " << j1 << " " << j2 << " " << g << endl;
-	      auto Ci = get_operator(sites,j1,"C"); 
-	      auto Cj = get_operator(sites,j2,"C"); 
-	      auto Cdagi = get_operator(sites,j1,"Cdag"); 
-	      auto Cdagj = get_operator(sites,j2,"Cdag"); 
-	      auto Delta = MPO(ampo); // new MPO
-	      auto Deltad = MPO(ampo); // new MPO
-	      nmultMPO(g*Ci,Cj,Delta,{"Maxm",maxm,"Cutoff",cutoff});
-	      nmultMPO(gd*Cdagj,Cdagi,Deltad,{"Maxm",maxm,"Cutoff",cutoff});
+	      // products of the operators with their strings
+	      auto cc = fermionic_string_spinless(j2,"C") ;
+	      for (auto op : fermionic_string_spinless(j1,"C")) cc.push_back(op);
+	      auto dd = fermionic_string_spinless(j1,"Cdag") ;
+	      for (auto op : fermionic_string_spinless(j2,"Cdag")) dd.push_back(op);
+	      auto Delta = g*product_operator(sites,cc); // C_j C_i
+	      auto Deltad = gd*product_operator(sites,dd); // Cdag_i Cdag_j
 	      H = sum(H,Delta); // add contribution
 	      H = sum(H,Deltad); // add contribution
       }
@@ -133,7 +133,6 @@ int site_type(int index) {
       called = 1; // next time do not read
       };
     out = stypes.at(index); // get the value
-    cout << index << " site is of type  " << out << endl ;
     return out ;
 }
 
@@ -0,0 +1,87 @@
+// time evolution of operators in the Heisenberg picture
+// A(t) = exp(iHt) A exp(-iHt) is kept as an MPO, and each step multiplies
+// it on both sides by exp(-iH dt) ~ W(tau(1+i)/2) W(tau(1-i)/2) with
+// tau = i*dt (and its hermitian conjugate), as in the purification
+// all the products are MPO-MPO products truncated with maxm and cutoff
+
+
+
+// hermitian conjugate of an MPO
+static auto mpo_dagger=[](MPO A) {
+  for (int j=1;j<=A.N();j++) A.Aref(j) = swapPrime(dag(A.A(j)),0,1,Site) ;
+  return A ;
+} ;
+
+
+
+// operator entanglement entropy in each bond, with the MPO seen as
+// a vector with the inner product Tr(A^dagger B)
+static auto operator_entropies=[](MPO A) {
+  auto out = std::vector<double>() ;
+  A.position(1) ;
+  for (int b=1;b<A.N();b++) { // sweep to the right
+    auto wf = A.A(b)*A.A(b+1) ;
+    auto U = A.A(b) ;
+    ITensor S,V ;
+    auto spectrum = svd(wf,U,S,V) ;
+    auto ps = spectrum.eigs() ;
+    Real norm = 0.0, SvN = 0.0 ;
+    for (auto p : ps) norm += p ;
+    for (auto p : ps) if (p/norm > 1E-12) SvN += -(p/norm)*log(p/norm) ;
+    out.push_back(SvN) ;
+    A.Aref(b) = U ; // left orthogonal
+    A.Aref(b+1) = S*V ; // next center
+  } ;
+  return out ;
+} ;
+
+
+
+// evolve heisenberg_A.in and write in HEISENBERG.OUT, for each time,
+// the OTOC <B A(t) B A(t)> with B in heisenberg_B.in, the norm
+// Tr(A(t)^dagger A(t))/Tr(1) and the operator entanglement of each bond
+// the OTOC is computed at infinite temperature, or in the ground state
+// if heisenberg_state = GS
+static auto heisenberg_evolution=[]() {
+  auto sites = get_sites();
+  auto ampo = get_ampo(sites) ; // get the ampo for the Hamiltonian
+  int maxm = get_int_value("maxm") ; // bond dimension
+  auto cutoff = get_float_value("cutoff") ; // cutoff
+  auto args = Args({"Maxm",maxm,"Cutoff",cutoff}) ;
+  auto dt = get_float_value("heisenberg_dt") ; // time step
+  int nt = get_int_value("heisenberg_nt") ; // number of steps
+  bool gs = get_str("heisenberg_state")=="GS" ; // ground state OTOC
+  auto A = get_mpo_operator("heisenberg_A.in") ; // evolved operator
+  auto B = get_mpo_operator("heisenberg_B.in") ; // other operator
+  MPS psi ;
+  if (gs) psi = get_gs() ; // get the ground state
+  Cplx tau = Cplx_i*dt ; // exp(-iH dt) = exp(-tau H)
+  auto U1 = toExpH<ITensor>(ampo,0.5*tau*(1.0+Cplx_i)) ;
+  auto U2 = toExpH<ITensor>(ampo,0.5*tau*(1.0-Cplx_i)) ;
+  auto Ud1 = toExpH<ITensor>(ampo,0.5*conj(tau)*(1.0-Cplx_i)) ;
+  auto Ud2 = toExpH<ITensor>(ampo,0.5*conj(tau)*(1.0+Cplx_i)) ;
+  ofstream myfile;
+  myfile.open("HEISENBERG.OUT"); // open file
+  for (int k=0;k<=nt;k++) {
+    if (k>0) { // A -> U^dagger A U
+      MPO X ;
+      nmultMPO(U1,A,X,args) ; // A U1
+      nmultMPO(U2,X,A,args) ; // A U1 U2
+      nmultMPO(A,Ud1,X,args) ; // Ud1 A U1 U2
+      nmultMPO(X,Ud2,A,args) ; // Ud2 Ud1 A U1 U2
+    } ;
+    MPO BA ;
+    nmultMPO(A,B,BA,args) ; // B A(t)
+    Cplx otoc ;
+    if (gs) otoc = overlapC(psi,BA,BA,psi) ; // in the ground state
+    else otoc = mpo_trace_product(mpo_dagger(BA),BA,true) ; // Tr(BABA)/Tr(1)
+    auto n = real(mpo_trace_product(A,A,true)) ; // norm of the operator
+    cout << "Heisenberg time = " << k*dt << ", OTOC = " << otoc << endl ;
+    myfile << std::setprecision(20) << k*dt << "  " << real(otoc) << "  "
+	    << imag(otoc) << "  " << n ;
+    for (auto s : operator_entropies(A)) myfile << "  " << s ;
+    myfile << endl ;
+  } ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
@@ -46,42 +46,41 @@ static auto moments_vi_vj_full=[](auto m, auto vi, auto vj, int n) {
 
 
 
+// Chebyshev moments <v|T_k(m)|v> for k=0,...,n+1, using that
+// <v|T_{2k}|v> = 2<a_k|a_k> - mu_0 and <v|T_{2k+1}|v> = 2<a_k|a_{k+1}> - mu_1
+static auto chebyshev_moments_vv=[](MPO const& m, MPS const& v, int n,
+		Args const& args) {
+  auto mus = std::vector<std::complex<double>>() ; // moments
+  auto am = v*1.0 ; // T_{k-1}|v>
+  auto a = exactApplyMPO(v,m,args) ; // T_k|v>
+  auto mu0 = overlapC(v,v) ; // zeroth moment
+  auto mu1 = overlapC(v,a) ; // first moment
+  mus.push_back(mu0) ;
+  mus.push_back(mu1) ;
+  while (int(mus.size())<n+2) {
+    auto ap = exactApplyMPO(a,m,args) ;
+    ap = sum(2.0*ap,-1.0*am,args) ; // recursion relation
+    mus.push_back(2.0*overlapC(a,a) - mu0) ; // even moment
+    if (int(mus.size())<n+2) mus.push_back(2.0*overlapC(a,ap) - mu1) ; // odd
+    am = a ; // next iteration
+    a = ap ; // next iteration
+  } ;
+  return mus ;
+} ;
+
+
+
 // this is a modified technique that can be used when the
 // two KPM vectors are the same
 static auto moments_vi_accelerated=[](auto m, auto vi, int n) {
-  // technique use to apply the mpo
   ofstream myfile; // file for the moments
   myfile.open("KPM_MOMENTS.OUT"); // open file
   int kpmmaxm = get_int_value("kpmmaxm") ; // bond dimension for KPM
   auto kpmcutoff = get_float_value("kpm_cutoff") ; // bond dimension for KPM
-  auto v = vi*1.0 ; // initialize
-  auto am = vi*1.0 ; // initialize
-  auto a = vi*0.0 ; // initialize
-  a = exactApplyMPO(vi,m,{"Maxm",kpmmaxm,"Cutoff",kpmcutoff}) ;
-  auto ap = a*1.0 ; // initialize
-  auto bk = overlapC(vi,vi) ; // overlap
-  auto bk1 = overlapC(vi,a) ; // overlap
-  auto mu0 = bk ; // save the zeroth
-  auto mu1 = bk1 ; // save the first
-  myfile << std::setprecision(20) << real(bk) << "  "
-                       << std::setprecision(20)<< imag(bk) << endl;
-  myfile << std::setprecision(20) << real(bk1) << "  "
-                       << std::setprecision(20)<< imag(bk1) << endl;
-  int i ;
-  for(i=0;i<n/2;i++) {
-    ap = exactApplyMPO(a,m,{"Maxm",kpmmaxm,"Cutoff",kpmcutoff}) ;
-    ap = sum(2.0*ap,-1.0*am,{"Maxm",kpmmaxm,"Cutoff",kpmcutoff}) ; // recursion relation
-    bk = overlapC(a,a) ; // compute overlap term 
-    bk1 = overlapC(a,ap) ; // compute overlap term 
-    bk = 2*bk - mu0; // correction due to the trick
-    bk1 = 2*bk1 - mu1; // correction due to the trick
+  auto args = Args({"Maxm",kpmmaxm,"Cutoff",kpmcutoff}) ;
+  for (auto const& bk : chebyshev_moments_vv(m,vi,2*(n/2),args))
     myfile << std::setprecision(20) << real(bk) << "  "
                        << std::setprecision(20)<< imag(bk) << endl;
-    myfile << std::setprecision(20) << real(bk1) << "  "
-                       << std::setprecision(20)<< imag(bk1) << endl;
-    am = a*1.0; // next iteration
-    a = ap*1.0; // next iteration
-  } ;
   myfile.close();
   return 0 ;
 } ;
@@ -0,0 +1,40 @@
+// time evolution with a global Krylov space of MPS
+// psi -> exp(tau*H) psi is computed in the Lanczos basis generated by
+// applying the MPO of H to psi, so that long range Hamiltonians (with
+// a large MPO bond dimension) need no approximation of exp(tau*H)
+// the Krylov space grows until the error estimate is below the tolerance
+
+
+
+// one step psi -> exp(tau*H) psi, returns the dimension of the Krylov
+// space and the estimated error
+static auto krylov_step=[](MPO const& H, MPS& psi, Cplx tau, int kdim,
+		double tol, bool fittd, Args const& args) {
+  auto nphi = sqrt(real(overlapC(psi,psi))) ; // norm of the input
+  if (nphi==0.0) return std::make_pair(0,0.0) ; // nothing to do
+  auto vs = std::vector<MPS>() ; // Krylov vectors
+  auto as = std::vector<double>() ; // diagonal coefficients
+  auto bs = std::vector<double>() ; // off-diagonal coefficients
+  vs.push_back((1./nphi)*psi) ; // first vector
+  for (int k=0;k<kdim;k++) {
+    MPS w ;
+    if (fittd) w = fitApplyMPO(vs.at(k),H,args) ; // apply H
+    else w = exactApplyMPO(H,vs.at(k),args) ; // apply H
+    as.push_back(real(overlapC(vs.at(k),w))) ;
+    // the truncation spoils the orthogonality, so use all the vectors
+    for (auto const& v : vs) w = sum(w,-overlapC(v,w)*v,args) ;
+    auto b = sqrt(real(overlapC(w,w))) ; // next coefficient
+    int m = k+1 ; // dimension of the Krylov space
+    auto cs = tridiagonal_expm(as,bs,tau) ; // exp(tau T) on the first vector
+    auto err = b*abs(cs.at(m-1)) ; // weight leaking out of the Krylov space
+    if (err<tol or b<1e-12 or m==kdim) {
+      auto terms = std::vector<MPS>() ;
+      for (int n=0;n<m;n++) terms.push_back((nphi*cs.at(n))*vs.at(n)) ;
+      psi = sum(terms,args) ; // new wavefunction
+      return std::make_pair(m,err) ;
+    } ;
+    bs.push_back(b) ; // store
+    vs.push_back((1./b)*w) ; // next vector
+  } ;
+  return std::make_pair(0,0.0) ; // kdim<1
+} ;
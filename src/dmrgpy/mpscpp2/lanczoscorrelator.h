@@ -0,0 +1,58 @@
+// dynamical correlator with Lanczos vectors (continued fraction)
+// the Krylov space of H is built from |v0> = A2|GS>/|A2|GS>|, and
+// <GS|A1 (z-H)^-1 A2|GS> = |A2|GS>| sum_n <GS|A1|v_n> [(z-T)^-1]_{n0}
+// with T the tridiagonal matrix of the coefficients a_n, b_n
+
+static auto lanczos_correlator=[]() {
+  auto sites = get_sites();
+  // now get the operators
+  auto A1 = get_mpo_operator("dc_multioperator_i.in");
+  auto A2 = get_mpo_operator("dc_multioperator_j.in");
+  auto H = get_hamiltonian(sites) ; // get the Hamiltonian
+  auto psi = get_gs() ; // get the ground state
+  int maxm = get_int_value("maxm") ; // bond dimension
+  auto cutoff = get_float_value("cutoff") ; // cutoff of DMRG
+  int n = get_int_value("lanczos_n") ; // number of coefficients
+  bool reortho = get_bool("lanczos_reorthogonalize") ; // full reortho
+  auto args = Args({"Maxm", maxm, "Cutoff", cutoff}); // MPS arguments
+  auto dotc = [](MPS const& u, MPS const& v) { return overlapC(u,v) ; } ;
+  auto v = exactApplyMPO(A2, psi, args); // A|GS>
+  auto b0 = sqrt(real(dotc(v,v))) ; // norm of A|GS>
+  auto as = std::vector<double>() ; // diagonal coefficients
+  auto bs = std::vector<double>() ; // off-diagonal coefficients
+  auto cs = std::vector<std::complex<double>>() ; // <GS|A1|v_n>
+  auto vs = std::vector<MPS>() ; // stored vectors, for reorthogonalization
+  bs.push_back(b0) ; // b_0 is the norm of the starting vector
+  if (b0>1e-14) {
+    v = (1./b0)*v ; // normalize
+    auto vm = v*0. ; // previous vector
+    for (int i=0;i<n;i++) {
+      cs.push_back(overlapC(psi,A1,v)) ; // weight of this vector
+      if (reortho) vs.push_back(v) ; // store
+      auto w = exactApplyMPO(H, v, args); // H|v_n>
+      auto a = real(dotc(v,w)) ; // diagonal coefficient
+      as.push_back(a) ; // store
+      w = sum(w,-a*v,args) ; // remove the component in v_n
+      if (i>0) w = sum(w,-bs.at(i)*vm,args) ; // and in v_{n-1}
+      if (reortho) { // orthogonalize against all the previous vectors
+        for (auto const& vk : vs) w = sum(w,-dotc(vk,w)*vk,args) ;
+      } ;
+      auto b = sqrt(real(dotc(w,w))) ; // off-diagonal coefficient
+      cout << "Lanczos step " << i << ", a = " << a << ", b = " << b << endl;
+      if (i==n-1) break ; // last coefficient
+      if (b<1e-10) break ; // invariant subspace found
+      bs.push_back(b) ; // store
+      vm = v ; // store previous vector
+      v = (1./b)*w ; // next vector
+    } ;
+  } ;
+  // write a_n, b_n and <GS|A1|v_n>, b_0 being |A2|GS>|
+  ofstream myfile;
+  myfile.open("LANCZOS_COEFFICIENTS.OUT"); // open file
+  for (size_t i=0;i<as.size();i++) {
+    myfile << std::setprecision(20) << as.at(i) << "  " << bs.at(i) << "  "
+           << real(cs.at(i)) << "  " << imag(cs.at(i)) << endl;
+  } ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
@@ -61,3 +61,108 @@ static auto measure =[](auto psi, auto sites) {
   return 0 ;
 }
 ;
+
+
+
+// expectation values of the operators of get_operator_terms in all the
+// sites, in a single sweep from left to right: the local terms are
+// computed with the orthogonality center, and the ones with a string
+// (the same operator in all the sites to the left, as the Jordan-Wigner
+// string) with the left environment of that string
+// terms of other shapes are computed with the MPO of get_operator
+static auto local_expectation_values=[](MPS psi, auto sites,
+		std::vector<std::string> const& names) {
+  int N = sites.N() ;
+  auto out = std::vector<std::vector<Cplx>>(names.size(),
+		  std::vector<Cplx>(N,0.0)) ;
+  auto ts = std::vector<std::vector<OperatorTerms>>(N) ; // terms
+  auto strings = std::map<std::string,ITensor>() ; // left environments
+  auto string_of = [&](int j, std::vector<std::pair<std::string,int>> const&
+		  ops, std::string& s) { // operator of the string, if any
+    s = "" ;
+    int n = 0 ; // sites of the string
+    for (auto const& op : ops) {
+      if (op.second==j) continue ;
+      if (s.empty()) s = op.first ;
+      if (op.first!=s or op.second!=n+1) return false ; // not a string
+      n++ ;
+    } ;
+    return n==0 or n==j-1 ;
+  } ;
+  for (int j=1;j<=N;j++) { // terms of all the operators
+    for (auto const& name : names) {
+      ts.at(j-1).push_back(local_factor_terms(get_operator_terms(j-1,name))) ;
+      for (auto const& t : ts.at(j-1).back()) {
+        std::string s ;
+        if (string_of(j,t.second,s) and not s.empty()) strings[s] = ITensor() ;
+      } ;
+    } ;
+  } ;
+  psi.position(1) ;
+  auto n = real(overlapC(psi,psi)) ; // norm
+  for (int j=1;j<=N;j++) {
+    if (j>1) { // move the center and grow the strings
+      psi.position(j) ;
+      auto A = psi.A(j-1) ; // left orthogonal
+      auto Ad = dag(prime(prime(A,Site),Link)) ;
+      for (auto& L : strings) {
+        auto F = site_op(sites,L.first,j-1) ;
+        if (L.second) L.second = L.second*A*F*Ad ;
+        else L.second = A*F*Ad ;
+      } ;
+    } ;
+    auto A = psi.A(j) ; // orthogonality center
+    auto Ad = dag(prime(A,Site)) ; // for the local terms
+    auto As = Ad ; // for the terms with a string
+    if (j>1) As = dag(prime(prime(A,Site),commonIndex(psi.A(j-1),A,Link))) ;
+    for (size_t k=0;k<names.size();k++) {
+      for (auto const& t : ts.at(j-1).at(k)) {
+        std::string s ;
+        if (not string_of(j,t.second,s)) { // the whole MPO
+          auto ampo = AutoMPO(sites) ;
+          add_operator_terms(ampo,{t}) ;
+          out.at(k).at(j-1) += overlapC(psi,MPO(ampo),psi)/n ;
+          continue ;
+        } ;
+        ITensor O ; // operator in site j
+        for (auto const& op : t.second) {
+          if (op.second!=j) continue ;
+          auto o = site_op(sites,op.first,j) ;
+          if (O) O = multSiteOps(O,o) ; else O = o ;
+        } ;
+        if (not O) O = site_op(sites,"Id",j) ;
+        Cplx v ;
+        if (s.empty()) v = (A*O*Ad).cplx() ; // local term
+        else v = (strings.at(s)*A*O*As).cplx() ; // with a string
+        out.at(k).at(j-1) += t.first*v/n ;
+      } ;
+    } ;
+  } ;
+  return out ;
+} ;
+
+
+
+// measure the operators measure_local_operator_k in all the sites of the
+// state in wavefunction.mps (or the ground state if measure_local_gs),
+// the table is written in binary to MEASURE_LOCAL.BIN as two int32
+// (operators, sites) and then the complex expectation values
+static auto measure_local=[]() {
+  auto sites = get_sites() ;
+  MPS psi ;
+  if (get_bool("measure_local_gs")) psi = get_gs() ; // ground state
+  else psi = read_wf("wavefunction.mps") ;
+  int nop = get_int_value("measure_local_noperators") ; // operators
+  auto names = std::vector<std::string>() ;
+  for (int k=0;k<nop;k++)
+    names.push_back(get_str("measure_local_operator_"+std::to_string(k))) ;
+  auto vs = local_expectation_values(psi,sites,names) ;
+  ofstream myfile;
+  myfile.open("MEASURE_LOCAL.BIN",ios::out | ios::binary);
+  int32_t header[2] = {nop, sites.N()} ; // dimensions
+  myfile.write((char*)header,sizeof(header)) ;
+  for (auto const& v : vs) // complex<double> is stored as (re,im)
+    myfile.write((char*)v.data(),v.size()*sizeof(Cplx)) ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
@@ -17,6 +17,22 @@ bool same_mps(auto vi, auto vj) {
 
 
 
+// Tr(A^dagger B) for two MPO, or Tr(A^dagger B)/Tr(1) if normalized,
+// which is divided in each site so that it does not overflow for long
+// chains
+static auto mpo_trace_product=[](MPO const& A, MPO const& B,
+		bool normalized=false) {
+  ITensor E ;
+  for (int j=1;j<=A.N();j++) {
+    auto Ej = B.A(j)*dag(prime(A.A(j),Link)) ; // links of A are primed
+    if (normalized) Ej /= Real(findtype(A.A(j),Site).m()) ; // site dimension
+    if (E) E *= Ej ; else E = Ej ;
+  } ;
+  return E.cplx() ;
+} ;
+
+
+
 static auto sum_mpo=[](auto A1,auto A2) {
         int maxm = get_int_value("maxm") ; // bond dimension
         auto cutoff = get_float_value("cutoff") ;
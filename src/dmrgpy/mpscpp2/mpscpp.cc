@@ -3,6 +3,10 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <chrono>
 
 
 
@@ -12,6 +16,7 @@ using namespace std;
 
 
 #include"check_task.h" // read the different tasks
+#include"threads.h" // run jobs on several threads
 #include"get_sites.h" // get the sites from a file
 #include"mpsalgebra.h" // functions to deal with MPS
 #include"get_sweeps.h" // get the sweep info
@@ -30,7 +35,10 @@ using namespace std;
 #include"kpm.h" // KPM routines
 #include"compute_overlap.h" // Compute overlap
 #include"cvm_dynamical_correlator.h" // CVM dynamical correlator
+#include"lanczoscorrelator.h" // Lanczos dynamical correlator
 #include"time_evolution.h" // Time evolution
+#include"thermal.h" // finite temperature with purification
+#include"heisenberg.h" // operators in the Heisenberg picture
 #include"reduced_dm.h" // Reduced density matrix
 #include"dynamical_correlator_excited.h" // dynamical correlator with exited
 #include"vev.h" // VEV
@@ -55,6 +63,9 @@ main()
 //    if (check_task("correlator")) get_correlator() ; // write correlators 
 //    if (check_task("gap")) get_gap(H,sites,sweeps); // calculate the gap 
     if (check_task("entropy")) get_entropy(); 
+    if (check_task("entanglement_profile")) entanglement_profile(); 
+    if (check_task("mutual_information")) mutual_information(); 
+    if (check_task("measure_local")) measure_local(); // local observables
     if (check_task("write_sites")) write_sites(); 
     if (check_task("excited")) {
       get_excited(); // compute states 
@@ -67,24 +78,32 @@ main()
 //       get_moments_dos(sites,H);
 //    } ;
     if (check_task("cvm"))  cvm_dynamical_correlator() ; // CVM
+    if (check_task("cvm_grid"))  cvm_dynamical_correlator_grid() ; // CVM
+    if (check_task("lanczos_correlator"))  lanczos_correlator() ; // Lanczos
 // overlap task
     if (check_task("overlap"))  compute_overlap() ; // compute overlap
     if (check_task("time_evolution"))  quench() ; // time evolution
     if (check_task("exponential_eMwf"))  exponential_eMwf() ; 
     if (check_task("evolution_AeiHtB"))  evolution_AeiHtB() ; // time evolution
     if (check_task("evolution_measure"))  evolution_measure() ; // time evol
+    if (check_task("thermal_purification"))  thermal_purification() ; // T>0
+    if (check_task("heisenberg_evolution"))  heisenberg_evolution() ; // A(t)
     if (check_task("density_matrix"))  reduced_dm() ; // DM
+    if (check_task("density_matrix_subset"))  reduced_dm_subset() ; // DM
     if (check_task("vev"))  vev() ; // Vacuum expectation value
     if (check_task("applyoperator"))  applyoperator() ; 
-    if (check_task("overlap_aMb"))  overlap_aMb() ; 
+    if (check_task("overlap_aMb"))  overlap_aMb() ;
+    if (check_task("gram_matrix"))  gram_matrix() ; // matrix of overlaps 
     if (check_task("summps"))  get_summps() ; 
     if (check_task("random_mps"))  get_random_mps() ; 
     if (check_task("distribution"))  get_moments_distribution() ; 
+    if (check_task("distribution_batch"))  get_moments_distribution_batch() ; 
     if (check_task("general_kpm"))  general_kpm() ; 
     if (check_task("apply_inverse"))  apply_inverse() ; 
 //    if (check_task("excited_vev"))  excited_vev() ; // VEV excited
     if (check_task("dynamical_correlator_excited"))  
 	    dynamical_correlator_excited(); // DM
+    if (check_task("excited_matrix_elements"))  excited_matrix_elements() ;
     system("rm -f ERROR") ; // remove error file
     return 0;
     }
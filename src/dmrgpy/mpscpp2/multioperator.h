@@ -1,38 +1,122 @@
 
 // return a multioperator of a certain name
+// the products are expanded as AutoMPO terms and converted to a single
+// MPO, and only when there are more than multioperator_max_terms terms
+// (default 4096) the products and the sum are done with MPO in a binary
+// tree, which is compressed with maxm and cutoff only at the end
+
+
+
+// MPO with the product of the operators of a list, pairwise
+static auto tree_product=[](std::vector<MPO> const& As, Args const& args) {
+  auto out = As ;
+  while (out.size()>1) {
+    auto next = std::vector<MPO>() ;
+    for (size_t k=0;k+1<out.size();k+=2) {
+      MPO AB ;
+      nmultMPO(out.at(k+1),out.at(k),AB,args) ; // A B
+      next.push_back(AB) ;
+    } ;
+    if (out.size()%2==1) next.push_back(out.back()) ;
+    out = next ;
+  } ;
+  return out.at(0) ;
+} ;
+
+
+
+// MPO with the sum of the operators of a list, pairwise
+static auto tree_sum=[](std::vector<MPO> const& As, Args const& args) {
+  auto out = As ;
+  while (out.size()>1) {
+    auto next = std::vector<MPO>() ;
+    for (size_t k=0;k+1<out.size();k+=2)
+      next.push_back(sum(out.at(k),out.at(k+1),args)) ;
+    if (out.size()%2==1) next.push_back(out.back()) ;
+    out = next ;
+  } ;
+  return out.at(0) ;
+} ;
+
+
 
 static auto get_multioperator=[](std::string name, auto sites) {
-//	auto sites = get_sites(); //
-	auto out = Iden(sites); // get the identity
-	out = 0.*out; // initialize operator
+	auto t0 = std::chrono::steady_clock::now() ;
         int maxm = get_int_value("maxm") ; // bond dimension
         auto cutoff = get_float_value("cutoff") ;
 	auto args = Args({"Maxm", maxm, "Cutoff", cutoff});
+        int mpomaxm = get_int_value("mpomaxm") ; // get bond dimension
+	if (mpomaxm<5) { mpomaxm = 5000 ;}; // default value
+	int maxterms = get_int_value("multioperator_max_terms") ;
+	if (maxterms<2) maxterms = 4096 ; // default value
         auto nop = get_int_value(name+"_n") ; // number of operators
-	// loop over the different terms in the sum
+	// read the coefficient and the factors of each product
+	auto cs = std::vector<Cplx>() ;
+	auto factors = std::vector<std::vector<OperatorTerms>>() ;
+	double nterms = 0.0 ; // number of terms once expanded
 	for (int j=0;j<nop;j++) { // loop over operators
       	  auto namej = name+"_operator_"+std::to_string(j); // get this one
 	  int n = get_int_value(namej+"_nterms"); // number of terms
-	  auto A = Iden(sites); // get the identity as starting point
 	  auto cr = get_float_value(namej+"_coefficient_real") ; // real
 	  auto ci = get_float_value(namej+"_coefficient_imag") ; // imaginary
-	  auto cz = cr + 1i*ci; // complex coefficient
-	  A = cz*A; // multiply by the coefficient
+	  cs.push_back(cr + 1i*ci); // complex coefficient
+	  auto fs = std::vector<OperatorTerms>() ;
+	  double nj = 1.0 ;
   	  for (int i=0;i<n;i++) { // loop over the term of this coefficient
 		auto nameop = get_str(namej+"_term_"+
 				std::to_string(i)+"_name");
 		int iop = get_int_value(namej+"_term_"+
                                 std::to_string(i)+"_site");
-		// now read the operator
-		auto Ai = get_operator(sites,iop,nameop); // read it
-		auto ampot = AutoMPO(sites); // temporal one
-		auto mt = MPO(ampot) ; // create MPO
-		nmultMPO(Ai,A,mt,args); // multiply MPO
-		A = mt; // reassign
+		fs.push_back(local_factor_terms(get_operator_terms(iop,nameop)));
+		nj *= fs.back().size() ;
 	  };
-	  // now add the contribution to the output
-	auto tmp = sum(out,A, args); // add contribution
-	out = tmp; // reassign total result
+	  factors.push_back(fs) ;
+	  nterms += nj ;
 	}; // end loop
+	MPO out ;
+	if (nterms<=maxterms) { // expand all the products as AutoMPO terms
+	  auto ampo = AutoMPO(sites) ;
+	  for (int j=0;j<nop;j++) {
+	    auto prods = OperatorTerms({{cs.at(j),{}}}) ; // expanded product
+	    for (auto const& f : factors.at(j)) {
+	      auto next = OperatorTerms() ;
+	      for (auto const& p : prods) for (auto const& t : f) {
+	        auto ops = p.second ;
+		ops.insert(ops.end(),t.second.begin(),t.second.end()) ;
+		next.push_back({p.first*t.first,ops}) ;
+	      } ;
+	      prods = next ;
+	    } ;
+	    for (auto& p : prods) if (p.second.empty()) p.second = {{"Id",1}} ;
+	    add_operator_terms(ampo,prods) ;
+	  } ;
+	  if (ampo.size()==0) ampo += 0.0,"Id",1 ; // zero operator
+	  out = toMPO<ITensor>(ampo,{"Maxm",mpomaxm,"Exact",false});
+	}
+	else { // products and sum in a binary tree, compressed at the end
+	  auto targs = Args({"Maxm",mpomaxm,"Cutoff",1e-14}) ;
+	  auto As = std::vector<MPO>() ;
+	  for (int j=0;j<nop;j++) {
+	    auto Fs = std::vector<MPO>() ;
+	    for (auto const& f : factors.at(j)) {
+	      if (f.size()==1) { // a single product, with bond dimension 1
+		Fs.push_back(f.at(0).first*product_operator(sites,f.at(0).second));
+		continue ;
+	      } ;
+	      auto ampo = AutoMPO(sites) ;
+	      add_operator_terms(ampo,f) ;
+	      Fs.push_back(toMPO<ITensor>(ampo,{"Maxm",mpomaxm,"Exact",false}));
+	    } ;
+	    if (Fs.empty()) Fs.push_back(Iden(sites)) ;
+	    As.push_back(cs.at(j)*tree_product(Fs,targs)) ;
+	  } ;
+	  if (As.empty()) As.push_back(0.*Iden(sites)) ; // zero operator
+	  out = tree_sum(As,targs) ;
+	  out.orthogonalize(args) ;
+	} ;
+	auto t1 = std::chrono::steady_clock::now() ;
+	cout << "Multioperator " << name << " with " << nterms << " terms, "
+	     << "bond dimension " << maxM(out) << ", built in "
+	     << std::chrono::duration<double>(t1-t0).count() << " s" << endl ;
 	return out; // return output
 };
@@ -0,0 +1,30 @@
+// cache of the operators already built, so that asking again for the
+// same operator returns a copy (which shares the storage) of the first one
+// the keys include the id of the site index, so that operators of
+// different sets of sites are not mixed
+
+
+
+// memoize f() with the key k in the cache c, safe with several threads
+template<typename K, typename T, typename F>
+T cached_operator(std::map<K,T>& c, K const& k, F f) {
+  static std::mutex m ;
+  {
+    std::lock_guard<std::mutex> lock(m) ;
+    auto it = c.find(k) ;
+    if (it!=c.end()) return it->second ;
+  }
+  auto out = f() ; // built outside the lock
+  std::lock_guard<std::mutex> lock(m) ;
+  c.emplace(k,out) ;
+  return out ;
+}
+
+
+
+// operator name of the site j, as an ITensor
+static auto site_op=[](auto const& sites, std::string const& name, int j) {
+  static std::map<std::pair<Index::id_type,std::string>,ITensor> c ;
+  return cached_operator(c,std::make_pair(sites(j).id(),name),
+		  [&]() { return ITensor(sites.op(name,j)) ; }) ;
+} ;
@@ -1,3 +1,4 @@
+#include"operator_cache.h" // operators already built
 #include"fermionicoperators.h" // library with fermionic operators
 
 
@@ -11,78 +12,124 @@ static auto Iden=[](auto sites) {
 
 
 
-static auto get_operator= [](auto sites, int i, auto name) {
-	if (name=="Id") return Iden(sites) ; // return identity
-	auto ampo = AutoMPO(sites);
-	if (site_type(i)>1)  // spin site
-		ampo += 1.0,name,i+1 ;
-	else if (site_type(i)==1) { // spinful fermionic site
-        	if (name=="Sx") {
-        		ampo += 0.5,"Cdagdn",i+1,"Cup",i+1;
-        		ampo += 0.5,"Cdagup",i+1,"Cdn",i+1;
-        	} ;
-		if (name=="Sy") {
-        		ampo += -0.5*1i,"Cdagdn",i+1,"Cup",i+1;
-        		ampo += 0.5*1i,"Cdagup",i+1,"Cdn",i+1;
-        	} ;
-		if (name=="Sz") {
-        		ampo += 0.5,"Cdagup",i+1,"Cup",i+1;
-        		ampo += -0.5,"Cdagdn",i+1,"Cdn",i+1;
-        	} ;
-		if (name=="Cdag") {
-        		ampo += 1.0,"Cdagup",i+1;
-        		ampo += 1.0,"Cdagdn",i+1;
-        	} ;
-		if (name=="C") {
-        		ampo += 1.0,"Cup",i+1;
-        		ampo += 1.0,"Cdn",i+1;
-        	} ;
-		if (name=="Cup") {
-        		ampo += 1.0,"Cup",i+1;
-        	} ;
-		if (name=="Cdn") {
-        		ampo += 1.0,"Cdn",i+1;
-        	} ;
-		if (name=="Cdagup") {
-        		ampo += 1.0,"Cdagup",i+1;
-        	} ;
-		if (name=="Cdagdn") {
-        		ampo += 1.0,"Cdagdn",i+1;
-        	} ;
-		// superconducting terms
-		if (name=="delta") {
-        		ampo += 1.0,"Cdn",i+1,"Cup",i+1;
-        	} ;
-		if (name=="deltad") {
-        		ampo += 1.0,"Cdagdn",i+1,"Cdagup",i+1;
-        	} ;
-		// density terms
-		if (name=="density") {
-        		ampo += 1.0,"Cdagdn",i+1,"Cdn",i+1;
-        		ampo += 1.0,"Cdagup",i+1,"Cup",i+1;
-        	} ;
-		if (name=="density_up") {
-        		ampo += 1.0,"Cdagup",i+1,"Cup",i+1;
-        	} ;
-		if (name=="density_dn") {
-        		ampo += 1.0,"Cdagdn",i+1,"Cdn",i+1;
-        	} ;
-	}
-	else if (site_type(i)==0) { // spinless fermionic site
-		cout << "Requesting site " << i << endl;
-//		if (name=="Cdag") {
-  //      		ampo += 1.0,"Cdag",i+1;
-    //    	} ;
-		if ((name=="C") or (name=="Cdag")) {
-			return fermionic_operator_spinless(sites,i,name) ;
-        	} ;
-		// density terms
-		if (name=="density") {
-        		ampo += 1.0,"Cdag",i+1,"C",i+1;
-        	} ;
-        };
-        auto m = MPO(ampo) ;	
-return m ;
+// terms of the operator name in site i, as a sum of products of
+// AutoMPO operators, each one a coefficient and a list of (name,site)
+// with the sites starting in 1
+using OperatorTerms = std::vector<std::pair<Cplx,
+      std::vector<std::pair<std::string,int>>>> ;
+
+// operators of the fermionic sites, as sums of products of local
+// operators, for spinful (1) and spinless (0) sites
+using LocalTerms = std::vector<std::pair<Cplx,std::vector<std::string>>> ;
+
+static std::map<std::string,LocalTerms> const spinful_operators = {
+	{"Sx",{{0.5,{"Cdagdn","Cup"}},{0.5,{"Cdagup","Cdn"}}}},
+	{"Sy",{{-0.5*1i,{"Cdagdn","Cup"}},{0.5*1i,{"Cdagup","Cdn"}}}},
+	{"Sz",{{0.5,{"Cdagup","Cup"}},{-0.5,{"Cdagdn","Cdn"}}}},
+	{"Cdag",{{1.0,{"Cdagup"}},{1.0,{"Cdagdn"}}}},
+	{"C",{{1.0,{"Cup"}},{1.0,{"Cdn"}}}},
+	{"Cup",{{1.0,{"Cup"}}}},
+	{"Cdn",{{1.0,{"Cdn"}}}},
+	{"Cdagup",{{1.0,{"Cdagup"}}}},
+	{"Cdagdn",{{1.0,{"Cdagdn"}}}},
+	// superconducting terms
+	{"delta",{{1.0,{"Cdn","Cup"}}}},
+	{"deltad",{{1.0,{"Cdagdn","Cdagup"}}}},
+	// density terms
+	{"density",{{1.0,{"Cdagdn","Cdn"}},{1.0,{"Cdagup","Cup"}}}},
+	{"density_up",{{1.0,{"Cdagup","Cup"}}}},
+	{"density_dn",{{1.0,{"Cdagdn","Cdn"}}}},
+	{"density2",{{1.0,{"Ntot"}},{2.0,{"Nupdn"}}}}, // square of the density
+} ;
+
+static std::map<std::string,LocalTerms> const spinless_operators = {
+	// density terms
+	{"density",{{1.0,{"Cdag","C"}}}},
+	{"density2",{{1.0,{"Cdag","C"}}}},
+} ;
+
+
+
+static auto get_operator_terms= [](int i, std::string const& name) {
+	auto out = OperatorTerms() ;
+	auto add = [&](Cplx c, std::vector<std::string> const& ops) {
+		auto p = std::vector<std::pair<std::string,int>>() ;
+		for (auto const& op : ops) p.push_back({op,i+1}) ;
+		out.push_back({c,p}) ;
+	} ;
+	if (name=="Id") { add(1.0,{"Id"}) ; return out ; } ; // identity
+	int type = site_type(i) ;
+	if (type>1) { add(1.0,{name}) ; return out ; } ; // spin site
+	if ((type==0) and ((name=="C") or (name=="Cdag"))) { // with strings
+		out.push_back({1.0,fermionic_string_spinless(i,name)}) ;
+		return out ;
+	} ;
+	auto const& table = (type==1) ? spinful_operators : spinless_operators ;
+	auto it = table.find(name) ;
+	if (it!=table.end()) for (auto const& t : it->second) add(t.first,t.second);
+	return out ;
+}
+;
+
+
+
+// add the terms of an operator to an AutoMPO
+static auto add_operator_terms= [](AutoMPO& ampo, OperatorTerms const& ts) {
+	for (auto const& t : ts) {
+		HTerm h ;
+		for (auto const& op : t.second) h.add(op.first,op.second) ;
+		h *= t.first ;
+		ampo.add(h) ;
+	} ;
+}
+;
+
+
+
+// name of a fermionic operator with the local Jordan-Wigner rewrite of
+// AutoMPO, used in the sites with an odd number of fermionic operators
+static auto local_fermionic_name=[](std::string const& name) {
+  static const std::map<std::string,std::string> jw = {{"Cdagup","Adagup"},
+	  {"Cup","Aup"},{"Cdagdn","Adagdn*Fup"},{"Cdn","Adn*Fup"},
+	  {"C","A"},{"Cdag","Adag"}} ;
+  auto it = jw.find(name) ;
+  return it==jw.end() ? name : it->second ;
+} ;
+
+
+
+// each factor as it would be as a single MPO: an odd product of fermionic
+// operators gets the local Jordan-Wigner rewrite of AutoMPO, so that it
+// does not get strings with the other factors of the product
+static auto local_factor_terms=[](OperatorTerms ts) {
+  for (auto& t : ts) {
+    auto& p = t.second ;
+    int nf = 0 ; // number of fermionic operators
+    for (auto const& op : p) if (op.first.front()=='C') nf++ ;
+    if (nf%2==0 or p.empty()) continue ;
+    for (auto& op : p) op.first = local_fermionic_name(op.first) ;
+    p.push_back({"F",p.back().second}) ; // single site term
+  } ;
+  return ts ;
+} ;
+
+
+
+// the MPO are built only the first time they are asked for
+static auto get_operator= [](auto sites, int i, std::string const& name) {
+	static std::map<std::tuple<Index::id_type,int,std::string,int>,MPO> c ;
+	auto k = std::make_tuple(sites(1).id(),i,name,site_type(i)) ;
+	return cached_operator(c,k,[&]() {
+	  if (name=="Id") return Iden(sites) ; // return identity
+	  auto ts = get_operator_terms(i,name) ;
+	  if (ts.size()==1) { // single product, with bond dimension 1
+		auto t = local_factor_terms(ts).at(0) ;
+		return t.first*product_operator(sites,t.second) ;
+	  } ;
+	  auto ampo = AutoMPO(sites);
+	  add_operator_terms(ampo,ts) ;
+	  return MPO(ampo) ;
+	}) ;
 }
 ;
 
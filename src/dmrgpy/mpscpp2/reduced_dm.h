@@ -32,16 +32,92 @@ static auto reduced_dm=[]() {
   // function to write the data
   ofstream filerdm; // file for the DM
   filerdm.open("DM.OUT"); // open file
-  filerdm.close(); //close file
-  auto doPrint = [](auto z) { 
-          ofstream filerdm; // file for the DM
-          filerdm.open("DM.OUT", ios::out | ios::app ); // open file
+  auto doPrint = [&](auto z) { 
 	  filerdm << std::setprecision(8) << real(z) << "  " ;
 	  filerdm << std::setprecision(8) << imag(z) << endl ;
-          filerdm.close(); //close file
   };
 //  auto doPrint = [](auto x) { cout << x << endl; };
   // evaluate the tensor in the function
   cout << rho << endl;
   rho.visit(doPrint); // loop over tensor
+  filerdm.close(); //close file
 };
+
+
+
+// reduced density matrix of the sites ks (starting in 1, in increasing
+// order, not necessarily contiguous), as a tensor with the site indices
+// of ks for the kets and primed for the bras
+// the orthogonality center is moved to the first site, and the sites
+// in between that are not in ks are traced out with transfer matrices
+static auto reduced_dm_sites=[](MPS psi, std::vector<int> const& ks) {
+  int i0 = ks.front(), i1 = ks.back() ;
+  psi.position(i0) ; // left of i0 is the identity
+  psi /= sqrt(real(overlapC(psi,psi))) ; // normalize
+  // estimate of the cost before doing the contraction
+  double flops = 0.0, mem = 0.0, dk = 1.0 ; // dk is d^2 of the open sites
+  for (int k=i0;k<=i1;k++) {
+    double ml = (k>1) ? commonIndex(psi.A(k-1),psi.A(k),Link).m() : 1 ;
+    double mr = (k<psi.N()) ? commonIndex(psi.A(k),psi.A(k+1),Link).m() : 1 ;
+    double d = findtype(psi.A(k),Site).m() ;
+    if (std::find(ks.begin(),ks.end(),k)!=ks.end()) dk *= d*d ;
+    flops += 2.0*ml*mr*d*dk*(ml+mr) ; // ket and bra of this site
+    mem = std::max(mem,16.0*mr*mr*dk) ; // size of the environment
+  } ;
+  cout << "Reduced density matrix of " << ks.size() << " sites, "
+       << "dimension " << sqrt(dk) << ", estimated cost " << flops
+       << " flops and " << mem/1e6 << " MB" << endl ;
+  ITensor rho ;
+  for (int k=i0;k<=i1;k++) {
+    auto A = psi.A(k) ;
+    bool open = std::find(ks.begin(),ks.end(),k)!=ks.end() ;
+    auto Ad = open ? prime(A,Site) : A ; // bra of this site
+    if (k>i0) Ad = prime(Ad,commonIndex(psi.A(k-1),A,Link)) ;
+    if (k<i1) Ad = prime(Ad,commonIndex(A,psi.A(k+1),Link)) ;
+    if (rho) rho *= A ; else rho = A ;
+    rho *= dag(Ad) ;
+  } ;
+  return rho ;
+} ;
+
+
+
+// reduced density matrix of the sites rdm_site_k (starting in 0) of the
+// state in wavefunction.mps, written in binary to DM.BIN as the int32
+// number of sites and their dimensions, and then the complex matrix
+// <a|rho|b> with a row-major order, the first site being the slowest
+static auto reduced_dm_subset=[]() {
+  auto psi = read_wf("wavefunction.mps") ;
+  int n = get_int_value("rdm_nsites") ; // number of sites
+  auto ks = std::vector<int>() ;
+  for (int k=0;k<n;k++)
+    ks.push_back(get_int_value("rdm_site_"+std::to_string(k))+1) ;
+  std::sort(ks.begin(),ks.end()) ;
+  auto rho = reduced_dm_sites(psi,ks) ;
+  auto is = std::vector<Index>() ; // site indices
+  int32_t dim = 1 ;
+  auto header = std::vector<int32_t>({n}) ;
+  for (auto k : ks) {
+    is.push_back(findtype(psi.A(k),Site)) ;
+    header.push_back(is.back().m()) ;
+    dim *= is.back().m() ;
+  } ;
+  auto out = std::vector<Cplx>(dim*dim) ;
+  auto ivs = std::vector<IndexVal>(2*n) ;
+  for (int a=0;a<dim;a++) for (int b=0;b<dim;b++) {
+    int ra = a, rb = b ; // digits of a and b, the last site the fastest
+    for (int k=n-1;k>=0;k--) {
+      int d = is.at(k).m() ;
+      ivs.at(k) = is.at(k)(ra%d+1) ;
+      ivs.at(n+k) = prime(is.at(k))(rb%d+1) ;
+      ra /= d ; rb /= d ;
+    } ;
+    out.at(a*dim+b) = rho.cplx(ivs) ;
+  } ;
+  ofstream myfile;
+  myfile.open("DM.BIN",ios::out | ios::binary);
+  myfile.write((char*)header.data(),header.size()*sizeof(int32_t)) ;
+  myfile.write((char*)out.data(),out.size()*sizeof(Cplx)) ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
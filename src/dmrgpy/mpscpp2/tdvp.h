@@ -0,0 +1,168 @@
+// time evolution with the time dependent variational principle (TDVP)
+// each step sweeps the chain forth and back, evolving the local tensors
+// with the effective Hamiltonian given by the environments of H
+// the local exponentials are computed in a Krylov space
+
+
+
+// exp(tau*T) applied to the first vector, with T the tridiagonal
+// matrix with diagonal as and off-diagonal bs, returns the coefficients
+static auto tridiagonal_expm=[](std::vector<double> const& as,
+		std::vector<double> const& bs, Cplx tau) {
+  int m = as.size() ; // dimension of the Krylov space
+  auto i = Index("krylov",m) ; // small matrix
+  auto T = ITensor(i,prime(i)) ;
+  for (int n=1;n<=m;n++) T.set(i(n),prime(i)(n),as.at(n-1)) ;
+  for (int n=1;n<m;n++) {
+    T.set(i(n),prime(i)(n+1),bs.at(n-1)) ;
+    T.set(i(n+1),prime(i)(n),bs.at(n-1)) ;
+  } ;
+  auto cs = expHermitian(T,tau)*setElt(i(1)) ; // exp(tau T) on the first
+  auto out = std::vector<Cplx>(m) ;
+  for (int n=1;n<=m;n++) out.at(n-1) = cs.cplx(prime(i)(n)) ;
+  return out ;
+} ;
+
+
+
+// compute exp(tau*A)|phi> for a Hermitian local operator, where
+// Aprod(v,Av) applies A, using a Lanczos basis of at most kdim vectors
+static auto krylov_expm=[](auto const& Aprod, ITensor& phi, Cplx tau,
+		int kdim, double tol) {
+  auto nphi = norm(phi) ; // norm of the input
+  if (nphi==0.0) return ; // nothing to do
+  auto vs = std::vector<ITensor>() ; // Krylov vectors
+  auto as = std::vector<double>() ; // diagonal coefficients
+  auto bs = std::vector<double>() ; // off-diagonal coefficients
+  vs.push_back(phi/nphi) ; // first vector
+  for (int k=0;k<kdim;k++) {
+    ITensor w ;
+    Aprod(vs.at(k),w) ; // apply the operator
+    as.push_back(real((dag(vs.at(k))*w).cplx())) ;
+    for (auto const& v : vs) w -= (dag(v)*w).cplx()*v ; // full reortho
+    auto b = norm(w) ; // next coefficient
+    int m = k+1 ; // dimension of the Krylov space
+    auto cs = tridiagonal_expm(as,bs,tau) ; // exp(tau T) on the first vector
+    // the error is given by the weight leaking out of the Krylov space
+    if (b*abs(cs.at(m-1))<tol or b<1e-12 or m==kdim) {
+      phi = cs.at(0)*vs.at(0) ;
+      for (int n=2;n<=m;n++) phi += cs.at(n-1)*vs.at(n-1) ;
+      phi *= nphi ; // restore the norm
+      return ;
+    } ;
+    bs.push_back(b) ; // store
+    vs.push_back(w/b) ; // next vector
+  } ;
+} ;
+
+
+
+// product with the effective Hamiltonian of one site (W) or
+// of a bond (no W), with environments L and R
+static auto tdvp_local_product=[](ITensor const& L, ITensor const& W,
+		ITensor const& R, ITensor const& phi, ITensor& phip) {
+  phip = phi ;
+  if (L) phip *= L ; // left block
+  if (W) phip *= W ; // local MPO tensor
+  if (R) phip *= R ; // right block
+  phip.noprime() ;
+} ;
+
+
+
+// add site j to a left (or right) environment E of H
+static auto tdvp_env=[](ITensor const& E, ITensor const& A, ITensor const& W) {
+  auto out = A*W*dag(prime(A)) ;
+  if (E) out *= E ; // previous sites
+  return out ;
+} ;
+
+
+
+// one step of the two-site TDVP, psi -> exp(tau*H) psi
+static auto tdvp_step_two_site=[](MPO const& H, MPS& psi, Cplx tau,
+		int kdim, double tol, Args const& args) {
+  int N = psi.N() ; // number of sites
+  psi.position(1) ; // orthogonality center in the first site
+  LocalMPO<ITensor> PH(H,args); // environments of H
+  for(int b = 1, ha = 1; ha <= 2; sweepnext(b,ha,N)) {
+    PH.position(b,psi); // environments in this bond
+    auto phi = psi.A(b)*psi.A(b+1) ; // two-site tensor
+    auto prod = [&PH](ITensor const& v, ITensor& Av) { PH.product(v,Av) ; } ;
+    krylov_expm(prod,phi,tau/2.,kdim,tol) ; // forward in time
+    psi.svdBond(b,phi,(ha==1?Fromleft:Fromright),PH,args) ; // truncate
+    if ((ha==1 and b==N-1) or (ha==2 and b==1)) continue ; // at the edges
+    // backward evolution of the site that the sweep moves into
+    int j = (ha==1 ? b+1 : b) ; // next site
+    auto L = PH.L() ; // left block
+    auto R = PH.R() ; // right block
+    if (ha==1) L = tdvp_env(L,psi.A(b),H.A(b)) ; // add site b
+    else R = tdvp_env(R,psi.A(b+1),H.A(b+1)) ; // add site b+1
+    auto W = H.A(j) ;
+    auto prod1 = [&](ITensor const& v, ITensor& Av) {
+      tdvp_local_product(L,W,R,v,Av) ; } ;
+    auto A = psi.A(j) ;
+    krylov_expm(prod1,A,-tau/2.,kdim,tol) ; // backward in time
+    psi.Aref(j) = A ;
+    psi.leftLim(j-1) ; // the orthogonality center is still j
+    psi.rightLim(j+1) ;
+  } ;
+} ;
+
+
+
+// one step of the one-site TDVP, psi -> exp(tau*H) psi
+// the bond dimension does not grow, so psi should have the
+// target bond dimension already (e.g. from a few two-site steps)
+static auto tdvp_step_one_site=[](MPO const& H, MPS& psi, Cplx tau,
+		int kdim, double tol, Args const& args) {
+  int N = psi.N() ; // number of sites
+  psi.position(1) ; // orthogonality center in the first site
+  auto LE = std::vector<ITensor>(N+2) ; // left environments
+  auto RE = std::vector<ITensor>(N+2) ; // right environments
+  for (int j=N;j>1;j--) RE.at(j) = tdvp_env(RE.at(j+1),psi.A(j),H.A(j)) ;
+  auto ITnull = ITensor() ; // no MPO tensor for the bond problems
+  // evolve site j forward by t, and the bond towards the next site
+  // backward by tb
+  auto sweep_site = [&](int j, int dir, Cplx t, Cplx tb) {
+    auto W = H.A(j) ;
+    auto A = psi.A(j) ;
+    auto prod1 = [&](ITensor const& v, ITensor& Av) {
+      tdvp_local_product(LE.at(j-1),W,RE.at(j+1),v,Av) ; } ;
+    krylov_expm(prod1,A,t,kdim,tol) ; // forward in time
+    if ((dir==1 and j==N) or (dir==-1 and j==1)) { // at the edges
+      psi.Aref(j) = A ; return ; } ;
+    int jn = j+dir ; // next site
+    auto Q = ITensor(findtype(A,Site)) ; // indexes kept in Q
+    int jp = j-dir ; // previous site
+    if (jp>=1 and jp<=N) Q = ITensor(findtype(A,Site),
+		    commonIndex(A,psi.A(jp),Link)) ;
+    ITensor S, V ;
+    svd(A,Q,S,V) ; // A = Q*S*V, with Q orthogonal
+    auto C = S*V ; // bond tensor
+    if (dir==1) LE.at(j) = tdvp_env(LE.at(j-1),Q,W) ;
+    else RE.at(j) = tdvp_env(RE.at(j+1),Q,W) ;
+    auto prod0 = [&](ITensor const& v, ITensor& Av) {
+      if (dir==1) tdvp_local_product(LE.at(j),ITnull,RE.at(jn),v,Av) ;
+      else tdvp_local_product(LE.at(jn),ITnull,RE.at(j),v,Av) ; } ;
+    krylov_expm(prod0,C,-tb,kdim,tol) ; // backward in time
+    psi.Aref(j) = Q ;
+    psi.Aref(jn) = C*psi.A(jn) ; // move the center
+    psi.leftLim(jn-1) ;
+    psi.rightLim(jn+1) ;
+  } ;
+  for (int j=1;j<N;j++) sweep_site(j,1,tau/2.,tau/2.) ; // left to right
+  sweep_site(N,-1,tau,tau/2.) ; // both half steps of the last site
+  for (int j=N-1;j>=1;j--) sweep_site(j,-1,tau/2.,tau/2.) ; // right to left
+} ;
+
+
+
+// one TDVP step, the variant is given by the method
+static auto tdvp_step=[](std::string const& method, MPO const& H,
+		MPS& psi, Cplx tau, Args const& args) {
+  int kdim = args.getInt("KrylovDim",30) ; // size of the Krylov space
+  auto tol = args.getReal("KrylovTol",1e-12) ; // error of the exponential
+  if (method=="tdvp1") tdvp_step_one_site(H,psi,tau,kdim,tol,args) ;
+  else tdvp_step_two_site(H,psi,tau,kdim,tol,args) ;
+} ;
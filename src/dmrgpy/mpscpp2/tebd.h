@@ -0,0 +1,122 @@
+// time evolution with TEBD for nearest-neighbour Hamiltonians
+// the MPS is kept in the right canonical form with the singular values
+// of each bond (Hastings form), so that all the gates of a layer,
+// acting on disjoint bonds, can be applied at the same time
+
+
+
+// two-site terms of the Hamiltonian, one per bond, the one-site terms
+// are split between the bonds of that site
+static auto tebd_bond_hamiltonians=[](AutoMPO const& ampo) {
+  auto sites = ampo.sites() ;
+  int N = sites.N() ; // number of sites
+  auto hb = std::vector<ITensor>(N) ; // bond Hamiltonians
+  for (int b=1;b<N;b++) hb.at(b) = ITensor() ; // initialize
+  auto op = [&sites](std::string const& name, int i) {
+    return ITensor(sites.op(name,i)) ; } ; // operator as an ITensor
+  auto add = [&](int b, ITensor const& h) {
+    if (hb.at(b)) hb.at(b) += h ; else hb.at(b) = h ; } ;
+  for (auto const& t : ampo.terms()) {
+    auto ops = std::vector<ITensor>(N+1) ; // operator in each site
+    auto is = std::vector<int>() ; // sites of this term
+    for (auto const& st : t.ops) {
+      if (isFermionic(st)) Error("TEBD does not support fermionic operators");
+      auto o = op(st.op,st.i) ; // operator in this site
+      if (ops.at(st.i)) ops.at(st.i) = multSiteOps(ops.at(st.i),o) ;
+      else { ops.at(st.i) = o ; is.push_back(st.i) ; } ;
+    } ;
+    std::sort(is.begin(),is.end()) ;
+    int i0 = is.at(0) ; // first site
+    if (is.size()==2 and is.at(1)==i0+1) { // nearest neighbours
+      add(i0,t.coef*ops.at(i0)*ops.at(i0+1)) ;
+    }
+    else if (is.size()==1) { // one-site term, split between the bonds
+      int nb = (i0>1) + (i0<N) ; // number of bonds of this site
+      if (i0>1) add(i0-1,(t.coef/Real(nb))*op("Id",i0-1)*ops.at(i0)) ;
+      if (i0<N) add(i0,(t.coef/Real(nb))*ops.at(i0)*op("Id",i0+1)) ;
+    }
+    else Error("TEBD needs a nearest-neighbour Hamiltonian") ;
+  } ;
+  for (int b=1;b<N;b++) // bonds without terms
+    if (not hb.at(b)) hb.at(b) = 0.0*op("Id",b)*op("Id",b+1) ;
+  return hb ;
+} ;
+
+
+
+// layers of the Trotter decomposition, each one given by the
+// first bond (1 for odd bonds, 2 for even bonds) and the fraction of
+// the time step, for a second or fourth order decomposition
+static auto tebd_layers=[](int order) {
+  auto out = std::vector<std::pair<int,double>>() ;
+  auto add = [&out](int b0, double c) { // merge equal consecutive layers
+    if (out.size()>0 and out.back().first==b0) out.back().second += c ;
+    else out.push_back(std::make_pair(b0,c)) ; } ;
+  auto second = [&add](double c) { // second order step
+    add(1,c/2.) ; add(2,c) ; add(1,c/2.) ; } ;
+  if (order==4) { // Suzuki fourth order decomposition
+    double p = 1.0/(4.0-pow(4.0,1.0/3.0)) ;
+    second(p) ; second(p) ; second(1.0-4.0*p) ; second(p) ; second(p) ;
+  }
+  else second(1.0) ;
+  return out ;
+} ;
+
+
+
+// gates exp(c*tau*h_b) for each layer
+static auto tebd_gates=[](std::vector<ITensor> const& hb, int order,
+		Cplx tau) {
+  auto layers = tebd_layers(order) ;
+  int N = hb.size() ; // number of sites
+  auto gates = std::vector<std::vector<std::pair<int,ITensor>>>() ;
+  for (auto const& l : layers) {
+    auto gl = std::vector<std::pair<int,ITensor>>() ; // gates of this layer
+    for (int b=l.first;b<N;b+=2)
+      gl.push_back(std::make_pair(b,expHermitian(hb.at(b),l.second*tau))) ;
+    gates.push_back(gl) ;
+  } ;
+  return gates ;
+} ;
+
+
+
+// one TEBD step, applying all the layers of gates
+static auto tebd_step=[](std::vector<std::vector<std::pair<int,ITensor>>>
+		const& gates, MPS& psi, int nthreads, Args const& args) {
+  int N = psi.N() ; // number of sites
+  auto B = std::vector<ITensor>(N+1) ; // right canonical tensors
+  auto Lam = std::vector<ITensor>(N+1) ; // singular values of each bond
+  auto C = psi.A(N) ; // start from the right
+  for (int b=N;b>1;b--) { // right to left sweep
+    ITensor U(commonIndex(psi.A(b-1),psi.A(b),Link)), S, V ;
+    svd(C,U,S,V,args) ;
+    B.at(b) = V ; // right orthogonal
+    Lam.at(b-1) = S ; // singular values
+    C = psi.A(b-1)*U*S ; // next site
+  } ;
+  B.at(1) = C ; // contains the norm
+  // apply a gate in bond i, in the Hastings form
+  auto apply_gate = [&](int i, ITensor const& G) {
+    auto phi = B.at(i)*B.at(i+1)*G ; // evolve
+    phi.mapprime(1,0,Site) ;
+    auto theta = phi ; // including the singular values on the left
+    auto X = ITensor(findtype(B.at(i),Site)) ;
+    if (i>1) {
+      theta *= Lam.at(i-1) ;
+      X = ITensor(findtype(B.at(i),Site),commonIndex(Lam.at(i-1),theta)) ;
+    } ;
+    ITensor Y, Z ;
+    svd(theta,X,Y,Z,args) ; // truncate
+    B.at(i+1) = Z ; // right orthogonal
+    B.at(i) = phi*dag(Z) ; // right orthogonal, without inverting Y
+    Lam.at(i) = Y ; // new singular values
+  } ;
+  for (auto const& gl : gates) { // loop over layers
+    parallel_for(gl.size(),nthreads,[&](int k) {
+      apply_gate(gl.at(k).first,gl.at(k).second) ; }) ;
+  } ;
+  for (int b=1;b<=N;b++) psi.Aref(b) = B.at(b) ; // store
+  psi.leftLim(0) ; // orthogonality center in the first site
+  psi.rightLim(2) ;
+} ;
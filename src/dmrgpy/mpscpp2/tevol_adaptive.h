@@ -0,0 +1,171 @@
+// time evolution with adaptive time step and bond dimension
+// each output step tau is split in substeps, the discarded weight is
+// given by the loss of norm, and the bond dimension is doubled (up to
+// tevol_maxm_max) while it exceeds tevol_truncation
+// the error of the step is then estimated by comparing the result with
+// twice as many substeps (step doubling), the number of substeps is
+// increased until the error is below tevol_dt_tol, and decreased
+// again when it is well below
+// each step is logged in TIME_EVOLUTION_ADAPTIVE.OUT as
+// time, substep, bond dimension, discarded weight, error, bond dimensions
+
+
+// state of the adaptive time evolution
+struct TevolAdaptive {
+  int nsub = 1 ; // number of substeps
+  int maxm = 1 ; // bond dimension
+  int step = 0 ; // number of steps done
+  std::vector<std::function<void(MPS&)>> evolvers ; // for each substep
+  ofstream log ; // file with the log
+};
+
+
+
+// number of substeps for the next step, longer if the error is small
+static auto tevol_adaptive_update=[](TevolAdaptive& s, double err,
+		double tol) {
+  if (err<tol/8. and s.nsub>1) s.nsub /= 2 ; // longer substeps
+} ;
+
+
+
+// stepper psi -> exp(tau*H) psi with adaptive substeps, for real time
+static auto get_adaptive_evolver=[](std::string const& method,
+		AutoMPO const& ampo, MPO const& expH, Cplx tau, bool fittd,
+		Args const& args) -> std::function<void(MPS&)> {
+  if (not (method=="tdvp" or method=="tdvp1" or method=="tebd" or
+			  method=="tebd4"))
+    Error("The adaptive time evolution needs tdvp or tebd") ;
+  int nmax = get_int_value("tevol_max_substeps") ; // maximum substeps
+  if (nmax<2) nmax = 16 ; // default value
+  auto tol = get_float_value("tevol_dt_tol") ; // error of each step
+  if (tol<=0.0) tol = 1e-4 ; // default value
+  auto wtol = get_float_value("tevol_truncation") ; // discarded weight
+  if (wtol<=0.0) wtol = 1e-8 ; // default value
+  auto s = std::make_shared<TevolAdaptive>() ;
+  s->maxm = args.getInt("Maxm") ; // initial bond dimension
+  int maxm_max = std::max(get_int_value("tevol_maxm_max"),s->maxm) ;
+  std::string name = "TIME_EVOLUTION_ADAPTIVE.OUT" ;
+  if (get_bool("tevol_restart")) { // recover the state from the log
+    std::ifstream fi(name) ;
+    std::string l ;
+    while (std::getline(fi,l)) {
+      std::istringstream ls(l) ;
+      double t, dt, w, err ;
+      ls >> t >> dt >> s->maxm >> w >> err ;
+      s->nsub = std::round(abs(tau)/dt)/2 ; // substeps of the step
+      tevol_adaptive_update(*s,err,tol) ;
+      s->step++ ;
+    } ;
+  } ;
+  open_tevol_file(s->log,name) ;
+  return [=](MPS& psi) {
+    auto evolver = [&](int m) -> std::function<void(MPS&)>& {
+      if (int(s->evolvers.size())<=m) s->evolvers.resize(m+1) ;
+      if (not s->evolvers.at(m)) { // build it with the current maxm
+        auto a = args ;
+        a.add("Maxm",s->maxm) ;
+        s->evolvers.at(m) = get_evolver(method,ampo,expH,tau/Real(m),fittd,a);
+      } ;
+      return s->evolvers.at(m) ;
+    } ;
+    auto run = [&](int m) { // m substeps
+      auto phi = psi ;
+      for (int k=0;k<m;k++) evolver(m)(phi) ;
+      return phi ;
+    } ;
+    auto n0 = real(overlapC(psi,psi)) ; // initial norm
+    auto pa = run(s->nsub) ; // with the current substeps
+    MPS pb ;
+    double err ;
+    while (true) {
+      // first the bond dimension, so that the truncation does not
+      // spoil the error of the time step
+      if (1.0-real(overlapC(pa,pa))/n0>wtol and s->maxm<maxm_max) {
+        s->maxm = std::min(2*s->maxm,maxm_max) ;
+        s->evolvers.clear() ; // built again with the new bond dimension
+        pa = run(s->nsub) ;
+        continue ;
+      } ;
+      pb = run(2*s->nsub) ; // with twice as many substeps
+      auto d = real(overlapC(pa,pa)) + real(overlapC(pb,pb))
+	      - 2.*real(overlapC(pa,pb)) ; // |pa-pb|^2
+      err = sqrt(std::abs(d)/n0) ; // relative error
+      if (err<=tol or 4*s->nsub>nmax) break ; // accept
+      s->nsub *= 2 ; // shorter substeps
+      pa = pb ; // already computed
+    } ;
+    psi = pb ; // the most accurate one
+    auto w = 1.0 - real(overlapC(psi,psi))/n0 ; // discarded weight
+    s->step++ ;
+    s->log << std::setprecision(20) << s->step*abs(tau) << "  "
+	   << abs(tau)/(2*s->nsub) << "  " << s->maxm << "  " << w << "  "
+	   << err ;
+    for (int b=1;b<psi.N();b++)
+      s->log << "  " << commonIndex(psi.A(b),psi.A(b+1),Link).m() ;
+    s->log << endl ;
+    tevol_adaptive_update(*s,err,tol) ;
+  } ;
+} ;
+
+
+
+// time stepper of the real time evolution, adaptive if tevol_adaptive
+static auto get_tevol_stepper=[](std::string const& method,
+		AutoMPO const& ampo, MPO const& expH, Cplx tau, bool fittd,
+		Args const& args) {
+  if (get_bool("tevol_adaptive"))
+    return get_adaptive_evolver(method,ampo,expH,tau,fittd,args) ;
+  return get_evolver(method,ampo,expH,tau,fittd,args) ;
+} ;
+
+
+
+// stepper psi -> exp(tau*H) psi for any tau, with TDVP or global Krylov
+static auto get_tau_stepper=[](std::string const& method,
+		AutoMPO const& ampo, bool fittd, Args const& args)
+	-> std::function<void(MPS&,Cplx)> {
+  auto H = MPO(ampo) ; // Hamiltonian
+  if (method=="tdvp" or method=="tdvp1")
+    return [=](MPS& psi, Cplx tau) { tdvp_step(method,H,psi,tau,args) ; } ;
+  if (method=="krylov") {
+    int kdim = args.getInt("KrylovDim",30) ; // maximum Krylov dimension
+    auto tol = args.getReal("KrylovTol",1e-12) ; // error of each step
+    auto kargs = args ;
+    kargs.add("Normalize",false) ; // for the fitting
+    return [=](MPS& psi, Cplx tau) {
+      krylov_step(H,psi,tau,kdim,tol,fittd,kargs) ; } ;
+  } ;
+  Error("The adaptive exponential needs tdvp or krylov") ;
+  return [](MPS& psi, Cplx tau) { } ;
+} ;
+
+
+
+// psi -> exp(tau*H) psi for complex tau, starting with n steps, and
+// choosing the length of each step by step doubling, so that the
+// relative error of each step is below tol
+static auto exponential_adaptive=[](std::function<void(MPS&,Cplx)> const&
+		step, MPS& psi, Cplx tau, int n, double tol) {
+  Cplx h = tau/Real(std::max(n,1)) ; // length of the step
+  Cplx done = 0.0 ; // evolved so far
+  int nsteps = 0 ; // accepted steps
+  while (abs(tau-done)>1e-12*abs(tau)) {
+    if (abs(h)>abs(tau-done)) h = tau-done ; // last step
+    auto pa = psi ; // one step
+    step(pa,h) ;
+    auto pb = psi ; // two half steps
+    step(pb,h/2.) ;
+    step(pb,h/2.) ;
+    auto nb = real(overlapC(pb,pb)) ;
+    auto d = real(overlapC(pa,pa)) + nb - 2.*real(overlapC(pa,pb)) ;
+    auto err = sqrt(std::abs(d)/nb) ; // relative error
+    if (err>tol and abs(h)>1e-6*abs(tau)) { h /= 2. ; continue ; } ; // again
+    psi = pb ; // accept the most accurate one
+    done += h ;
+    nsteps++ ;
+    cout << "Exponential step " << nsteps << ", |tau| = " << abs(h)
+	 << ", error = " << err << endl ;
+    if (err<tol/8.) h *= 2. ; // longer steps
+  } ;
+} ;
@@ -0,0 +1,86 @@
+// checkpoints of a time evolution, to continue it after an interruption
+// the checkpoint stores the number of steps done, the norm factor and
+// the MPS in binary, so that a restarted run gives the same output
+
+
+
+// number of steps between checkpoints, zero if they are not written
+static auto get_tevol_checkpoint_every=[]() {
+  if (not get_bool("tevol_checkpoint")) return 0 ;
+  return get_int_value("tevol_checkpoint_every") ;
+} ;
+
+
+
+// write the checkpoint, in a temporary file that is then renamed,
+// so that an interruption never leaves a broken checkpoint
+static auto write_tevol_checkpoint=[](MPS const& psi, int n, Cplx norm0) {
+  std::string name = "TEVOL_CHECKPOINT.BIN" ;
+  std::ofstream s(name+".tmp",std::ios::binary) ;
+  itensor::write(s,n) ; // number of steps done
+  itensor::write(s,norm0) ; // norm factor
+  psi.write(s) ; // wavefunction
+  s.close() ;
+  std::rename((name+".tmp").c_str(),name.c_str()) ;
+} ;
+
+
+
+// keep the first n lines of a file, if it exists
+static auto tevol_keep_lines=[](std::string name, int n) {
+  std::ifstream fi(name) ;
+  if (not fi.good()) return ; // no file
+  auto lines = std::vector<std::string>() ;
+  std::string l ;
+  while (int(lines.size())<n and std::getline(fi,l)) lines.push_back(l) ;
+  fi.close() ;
+  std::ofstream fo(name) ;
+  for (auto const& l : lines) fo << l << endl ;
+  fo.close() ;
+} ;
+
+
+
+// when restarting (tevol_restart), read the checkpoint into psi and
+// norm0 and return the number of steps done, the outputs with one line
+// per step are cut at that step, otherwise remove old checkpoints
+static auto start_tevol_checkpoint=[](MPS& psi, Cplx& norm0) {
+  if (not get_bool("tevol_restart")) {
+    std::remove("TEVOL_CHECKPOINT.BIN") ; // from a previous run
+    return 0 ;
+  } ;
+  int n = 0 ; // number of steps done
+  std::ifstream s("TEVOL_CHECKPOINT.BIN",std::ios::binary) ;
+  if (s.good()) { // there is a checkpoint
+    itensor::read(s,n) ; // number of steps done
+    itensor::read(s,norm0) ; // norm factor
+    psi.read(s) ; // wavefunction
+    s.close() ;
+  } ;
+  for (auto name : {"TIME_EVOLUTION.OUT","TIME_EVOLUTION_MATRIX.OUT",
+		  "TIME_EVOLUTION_KRYLOV.OUT","TIME_EVOLUTION_ADAPTIVE.OUT"})
+    tevol_keep_lines(name,n) ;
+  cout << "Restarting time evolution from step " << n << endl ;
+  return n ;
+} ;
+
+
+
+// ground state used as reference in the evolution, stored when there
+// are checkpoints so that a restart does not depend on a new DMRG
+static auto get_tevol_reference=[]() {
+  std::string name = "psi_tevol_reference.mps" ;
+  if (get_bool("tevol_restart") and std::ifstream(name).good())
+    return read_wf(name) ; // same state as the interrupted run
+  auto psi = get_gs() ; // get the ground state
+  if (get_tevol_checkpoint_every()>0) writeToFile(name,psi) ;
+  return psi ;
+} ;
+
+
+
+// open an output of the time evolution, appending to it when restarting
+static auto open_tevol_file=[](ofstream& f, std::string name) {
+  if (get_bool("tevol_restart")) f.open(name,std::ios::app) ;
+  else f.open(name) ;
+} ;
@@ -0,0 +1,94 @@
+// several observables measured in the same time evolution
+// operators acting on a single site are evaluated with the environments
+// of <bra|ket>, computed once per time step, and the rest as MPO
+
+
+// operator read from a file, either local (op in site) or an MPO
+struct TevolOperator {
+  bool local = false ; // acts on a single site
+  int site = 0 ; // site of the local operator
+  ITensor op ; // local operator
+  MPO mpo ; // general operator
+};
+
+
+
+// read an operator, detecting whether it acts on a single site
+static auto get_tevol_operator=[](std::string filename) {
+  auto sites = get_sites(); // read sites
+  auto ampo = get_ampo_operator(AutoMPO(sites),filename) ; // read ampo
+  TevolOperator out ;
+  out.local = (ampo.terms().size()>0) ;
+  if (out.local) out.site = ampo.terms().begin()->ops.front().i ; // first
+  for (auto const& t : ampo.terms()) { // check that all are in one site
+    int nf = 0 ; // number of fermionic operators
+    for (auto const& st : t.ops) {
+      if (isFermionic(st)) nf++ ;
+      if (st.i!=t.ops.front().i) out.local = false ;
+    } ;
+    if (nf%2==1) out.local = false ; // needs a Jordan-Wigner string
+    if (t.ops.front().i!=out.site) out.local = false ; // another site
+  } ;
+  if (not out.local) { // general operator
+    out.mpo = get_mpo_operator(filename) ;
+    return out ;
+  } ;
+  for (auto const& t : ampo.terms()) { // sum all the terms
+    auto o = ITensor(sites.op(t.ops.front().op,out.site)) ;
+    for (size_t k=1;k<t.ops.size();k++)
+      o = multSiteOps(o,ITensor(sites.op(t.ops.at(k).op,out.site))) ;
+    if (out.op) out.op += t.coef*o ; else out.op = t.coef*o ;
+  } ;
+  return out ;
+} ;
+
+
+
+// read the operators name_0.in, name_1.in, ...
+static auto get_tevol_operators=[](std::string name, int n) {
+  auto ops = std::vector<TevolOperator>() ;
+  for (int k=0;k<n;k++)
+    ops.push_back(get_tevol_operator(name+"_"+std::to_string(k)+".in")) ;
+  return ops ;
+} ;
+
+
+
+// matrix elements <bra|O_k|ket> of the local operators, using the left
+// and right environments of <bra|ket>, the rest are left as zero
+static auto tevol_local_elements=[](std::vector<TevolOperator> const& ops,
+		MPS const& bra, MPS const& ket) {
+  auto out = std::vector<Cplx>(ops.size(),0.0) ;
+  bool any = false ; // is there any local operator
+  for (auto const& o : ops) any = any or o.local ;
+  if (not any) return out ; // nothing to do
+  int N = ket.N() ; // number of sites
+  auto env = [&](ITensor const& E, int j) { // links of bra are primed
+    auto e = ket.A(j)*dag(prime(bra.A(j),Link)) ;
+    if (E) e *= E ; // previous sites
+    return e ;
+  } ;
+  auto L = std::vector<ITensor>(N+2) ; // left environments
+  auto R = std::vector<ITensor>(N+2) ; // right environments
+  for (int j=1;j<N;j++) L.at(j) = env(L.at(j-1),j) ;
+  for (int j=N;j>1;j--) R.at(j) = env(R.at(j+1),j) ;
+  for (size_t k=0;k<ops.size();k++) {
+    if (not ops.at(k).local) continue ;
+    int j = ops.at(k).site ;
+    auto z = ops.at(k).op*ket.A(j) ; // apply the operator
+    z = noprime(z,Site)*dag(prime(bra.A(j),Link)) ;
+    if (L.at(j-1)) z *= L.at(j-1) ; // left block
+    if (R.at(j+1)) z *= R.at(j+1) ; // right block
+    out.at(k) = z.cplx() ;
+  } ;
+  return out ;
+} ;
+
+
+
+// write a row of complex numbers in a file
+static auto write_tevol_row=[](ofstream& f, std::vector<Cplx> const& zs) {
+  for (auto const& z : zs)
+    f << std::setprecision(20) << real(z) << "  " << imag(z) << "  " ;
+  f << endl ;
+} ;
@@ -0,0 +1,68 @@
+// finite temperature with the purification of the thermal state
+// the purified state of the chain with ancillas is stored as the MPO
+// rho = exp(-beta*H/2), so that Z = Tr(rho^dagger rho) and
+// <A> = Tr(rho^dagger A rho)/Z, starting from the identity at beta=0
+// each step in beta uses exp(-tau*H) ~ W(tau(1+i)/2) W(tau(1-i)/2),
+// with W the first order MPO of toExpH, which is second order in tau
+
+
+
+// Tr(rho^dagger A rho) for two MPO
+static auto mpo_trace_expectation=[](MPO const& rho, MPO const& A) {
+  ITensor E ;
+  for (int j=1;j<=rho.N();j++) {
+    auto Ar = mapprime(A.A(j),0,2,Site)*mapprime(rho.A(j),1,2,Site) ;
+    auto Ej = Ar*dag(prime(rho.A(j),Link)) ; // links of rho^dagger primed
+    if (E) E *= Ej ; else E = Ej ;
+  } ;
+  return E.cplx() ;
+} ;
+
+
+
+// energy, log(Z) and observables (thermal_multioperator_k.in) in the
+// grid beta = k*thermal_dbeta for k=0,...,thermal_nbeta, in THERMAL.OUT
+static auto thermal_purification=[]() {
+  auto sites = get_sites();
+  auto H = get_hamiltonian(sites) ; // get the Hamiltonian
+  auto ampo = get_ampo(sites) ; // get the ampo for the Hamiltonian
+  int maxm = get_int_value("maxm") ; // bond dimension
+  auto cutoff = get_float_value("cutoff") ; // cutoff
+  auto args = Args({"Maxm",maxm,"Cutoff",cutoff}) ;
+  auto dbeta = get_float_value("thermal_dbeta") ; // step in beta
+  int nbeta = get_int_value("thermal_nbeta") ; // number of steps
+  int nop = get_int_value("thermal_noperators") ; // number of operators
+  auto As = std::vector<MPO>() ;
+  for (int k=0;k<nop;k++)
+    As.push_back(get_mpo_operator("thermal_multioperator_"
+			    +std::to_string(k)+".in")) ;
+  auto tau = dbeta/2. ; // rho = exp(-beta*H/2)
+  auto expH1 = toExpH<ITensor>(ampo,0.5*tau*(1.0+Cplx_i)) ;
+  auto expH2 = toExpH<ITensor>(ampo,0.5*tau*(1.0-Cplx_i)) ;
+  auto aid = AutoMPO(sites) ;
+  aid += 1.0,"Id",1 ;
+  auto rho = MPO(aid) ; // identity, infinite temperature
+  double lnZ = 0.0 ; // logarithm of the partition function
+  ofstream myfile;
+  myfile.open("THERMAL.OUT"); // open file
+  for (int k=0;k<=nbeta;k++) {
+    if (k>0) { // next beta
+      MPO r ;
+      nmultMPO(expH2,rho,r,args) ;
+      nmultMPO(expH1,r,rho,args) ;
+    } ;
+    auto n = real(mpo_trace_product(rho,rho)) ; // Z, relative to the last
+    lnZ += log(n) ;
+    rho *= 1.0/sqrt(n) ; // normalize, so that Tr(rho^dagger rho)=1
+    auto e = real(mpo_trace_expectation(rho,H)) ; // energy
+    cout << "beta = " << k*dbeta << ", energy = " << e << endl ;
+    myfile << std::setprecision(20) << k*dbeta << "  " << e << "  " << lnZ ;
+    for (auto const& A : As) {
+      auto z = mpo_trace_expectation(rho,A) ;
+      myfile << "  " << real(z) << "  " << imag(z) ;
+    } ;
+    myfile << endl ;
+  } ;
+  myfile.close(); // close file
+  return 0 ;
+} ;
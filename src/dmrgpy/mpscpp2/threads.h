@@ -0,0 +1,37 @@
+// run independent pieces of work on several threads
+
+// number of threads to use, as given in tasks.in
+static auto get_nthreads=[]() {
+  int n = get_int_value("nthreads") ; // number of threads
+  if (n<1) n = 1 ; // at least one
+  return n ;
+}
+;
+
+
+// split the range [0,n) in contiguous blocks, and call f(i0,i1)
+// for each block on a different thread
+static auto parallel_blocks=[](int n, int nthreads, auto f) {
+  if (nthreads>n) nthreads = n ; // no more threads than jobs
+  if (nthreads<=1) { f(0,n) ; return ; } ; // serial execution
+  auto workers = std::vector<std::thread>() ; // list of threads
+  int nb = n/nthreads ; // size of each block
+  int nr = n%nthreads ; // remaining jobs
+  int i0 = 0 ; // start of the block
+  for (int it=0;it<nthreads;it++) {
+    int i1 = i0 + nb + (it<nr ? 1 : 0) ; // end of the block
+    workers.push_back(std::thread(f,i0,i1)) ; // launch thread
+    i0 = i1 ; // next block
+  } ;
+  for (auto &w : workers) w.join() ; // wait for all of them
+}
+;
+
+
+// call f(i) for every i in [0,n), distributing over threads
+static auto parallel_for=[](int n, int nthreads, auto f) {
+  parallel_blocks(n,nthreads,[&f](int i0, int i1) {
+    for (int i=i0;i<i1;i++) f(i) ;
+  }) ;
+}
+;
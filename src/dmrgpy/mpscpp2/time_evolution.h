@@ -1,37 +1,77 @@
 // perform a time evolution
 
-static auto evoloperator=[](auto H, auto dt) {
-  auto sites = get_sites();
-  auto ampo = AutoMPO(sites); // generate ampo
-  ampo += 1.0,"Id", 1;
-  std::complex<double> z(0.0,-dt);
-  auto Iden = MPO(ampo); // identity
-  auto out = sum_mpo(Iden,z*H) ;
-  auto H2 = mult_mpo(H,H);
-  auto H3 = mult_mpo(H,H2);
-  out = sum_mpo(out,(0.5*z*z)*H2);
-  out = sum_mpo(out,(z*z*z/6.0)*H2);
-  return out;
+#include"tdvp.h" // TDVP time evolution
+#include"tebd.h" // TEBD time evolution
+#include"krylov.h" // global Krylov time evolution
+#include"tevol_observables.h" // several observables
+#include"tevol_checkpoint.h" // checkpoints
+#include"expmpo.h" // MPO of the time step
+
+// arguments for the time evolution, including the ones for TDVP
+static auto get_tevol_args=[]() {
+  int maxm = get_int_value("maxm") ; // bond dimension
+  auto cutoff = get_float_value("cutoff") ; // cutoff
+  int kdim = get_int_value("tevol_krylov_dim") ; // Krylov vectors
+  if (kdim<2) kdim = 30 ; // default value
+  auto ktol = get_float_value("tevol_krylov_tol") ; // Krylov error
+  if (ktol<=0.0) ktol = 1e-12 ; // default value
+  return Args({"Cutoff",cutoff,"Maxm",maxm,"KrylovDim",kdim,
+		  "KrylovTol",ktol});
 }
 ;
 
-static auto custom_exp=[](auto H, auto z) {
-  auto sites = get_sites();
-  auto ampo = AutoMPO(sites); // generate ampo
-  ampo += 1.0,"Id", 1;
-  auto Iden = MPO(ampo); // identity
-  auto out = sum_mpo(Iden,z*H) ;
-  auto H2 = mult_mpo(H,H);
-//  auto H3 = mult_mpo(H,H2);
-  out = sum_mpo(out,(0.5*z*z)*H2);
-//  out = sum_mpo(out,(z*z*z/6.0)*H2);
-  return out;
+
+// time stepper psi -> exp(tau*H) psi, with the MPO expH = exp(tau*H),
+// with TDVP if tevol_method is tdvp (two-site) or tdvp1 (one-site),
+// or with TEBD if it is tebd (second order) or tebd4 (fourth order),
+// or with a global Krylov space if it is krylov, writing the Krylov
+// dimension and the error of each step in TIME_EVOLUTION_KRYLOV.OUT
+static auto get_evolver=[](std::string const& method, AutoMPO const& ampo,
+		MPO const& expH, Cplx tau, bool fittd, Args const& args)
+	-> std::function<void(MPS&)> {
+  if (method=="krylov") {
+    auto H = MPO(ampo) ; // Hamiltonian
+    int kdim = args.getInt("KrylovDim",30) ; // maximum Krylov dimension
+    auto tol = args.getReal("KrylovTol",1e-12) ; // error of each step
+    auto kargs = args ;
+    kargs.add("Normalize",false) ; // for the fitting
+    auto f = std::make_shared<ofstream>() ;
+    open_tevol_file(*f,"TIME_EVOLUTION_KRYLOV.OUT") ;
+    return [=](MPS& psi) {
+      auto r = krylov_step(H,psi,tau,kdim,tol,fittd,kargs) ;
+      *f << r.first << "  " << std::setprecision(20) << r.second << endl ; } ;
+  } ;
+  if (method=="tdvp" or method=="tdvp1") {
+    auto H = MPO(ampo) ; // Hamiltonian
+    return [=](MPS& psi) { tdvp_step(method,H,psi,tau,args) ; } ;
+  } ;
+  if (method=="tebd" or method=="tebd4") {
+    if (real(tau)!=0.0) Error("TEBD is only implemented for real time") ;
+    auto hb = tebd_bond_hamiltonians(ampo) ; // two-site terms
+    auto gates = tebd_gates(hb,(method=="tebd4" ? 4 : 2),tau) ;
+    int nthreads = get_nthreads() ; // number of threads
+    return [=](MPS& psi) { tebd_step(gates,psi,nthreads,args) ; } ;
+  } ;
+  if (fittd) return [=](MPS& psi) { fitApplyMPO(psi,expH,psi,args) ; } ;
+  return [=](MPS& psi) { psi = exactApplyMPO(expH,psi,args) ; } ;
 }
 ;
 
+#include"tevol_adaptive.h" // adaptive time step and bond dimension
 
 
 
+// MPO exp(tau*H) of the mpo method, with get_exp_mpo if tevol_custom_exp
+// and toExpH otherwise, the other methods do not use it
+static auto get_tevol_expmpo=[](std::string const& method,
+		AutoMPO const& ampo, Cplx tau) {
+  if (method=="tdvp" or method=="tdvp1" or method=="tebd" or
+		  method=="tebd4" or method=="krylov") return MPO() ;
+  if (get_bool("tevol_custom_exp")) return get_exp_mpo(ampo,tau) ;
+  return toExpH<ITensor>(ampo,tau) ;
+} ;
+
+
 
 static auto quench=[]() {
   auto sites = get_sites();
@@ -39,7 +79,7 @@ static auto quench=[]() {
   auto A1 = get_mpo_operator("dc_multioperator_i.in");
   auto A2 = get_mpo_operator("dc_multioperator_j.in");
   auto H = get_hamiltonian(sites) ; // get the ampo for the Hamiltonian
-  auto psi = get_gs() ; // get the ground state
+  auto psi = get_tevol_reference() ; // get the ground state
   int maxm = get_int_value("maxm") ; // bond dimension
   auto cutoff = get_float_value("cutoff") ; // cutoff
   // apply the first operator
@@ -47,30 +87,54 @@ static auto quench=[]() {
   auto nt = get_int_value("tevol_nt"); // number of time steps
   auto dt = get_float_value("tevol_dt"); // delta of time
   int it;
-  auto args = Args("Cutoff=",cutoff,"Maxm=",maxm);
+  auto args = get_tevol_args() ; // arguments for the evolution
+  auto method = get_str("tevol_method") ; // method for the evolution
   // compute ground state energy
   auto EGS = overlap(psi,H,psi)/overlap(psi,psi); // ground state enrgy
   // get the AutoMPO
   auto ampo = get_ampo(sites) ; // get the ampo for the Hamiltonian
   // shift by the ground state energy
   ampo += -EGS,"Id", 1; // minus ground state energy
-  auto expH = MPO(ampo);
-  if (get_bool("tevol_custom_exp")) 
-    expH = evoloperator(MPO(ampo),dt) ; // create Hamiltonian
-  else expH = toExpH<ITensor>(ampo,dt*Cplx_i); 
-  ofstream fileevol; // file for the evolution
-  fileevol.open("TIME_EVOLUTION.OUT"); // time evolution
+  auto expH = get_tevol_expmpo(method,ampo,dt*Cplx_i) ; // time step
   auto psi1 = exactApplyMPO(psi,A1,args) ;
   auto psi2 = exactApplyMPO(psi,A2,args) ;
 //  normalize(psi1); // normalize
 //  normalize(psi2); // normalize
   auto norm0 = sqrt(overlapC(psi1,psi1)) ;
+  int it0 = start_tevol_checkpoint(psi1,norm0) ; // first step
+  int every = get_tevol_checkpoint_every() ; // steps between checkpoints
+  ofstream fileevol; // file for the evolution
+  open_tevol_file(fileevol,"TIME_EVOLUTION.OUT"); // time evolution
   auto fittd = get_bool("tevol_fit_td") ; // use fitting method
-  for (it=0;it<nt;it++) { // loop
-	      if (fittd) fitApplyMPO(psi1,expH,psi1,args) ; // evolve
-	      if (not fittd) psi1 = exactApplyMPO(expH,psi1,args); // evolve
+  auto evolve = get_tevol_stepper(method,ampo,expH,-dt*Cplx_i,fittd,args) ;
+  // several bra operators, <GS|B_k^dagger exp(-iHt) A1|GS> in each row
+  bool multi = get_bool("tevol_multioperators") ;
+  auto Bs = std::vector<TevolOperator>() ;
+  auto psiBs = std::vector<MPS>() ; // B_k|GS> for the non local ones
+  ofstream filematrix; // file for all the operators
+  if (multi) {
+    Bs = get_tevol_operators("dc_multioperator_j",
+		    get_int_value("tevol_noperators")) ;
+    for (auto& B : Bs) {
+      if (B.local) B.op = swapPrime(dag(B.op),0,1) ; // hermitian conjugate
+      if (B.local) psiBs.push_back(psi) ; // not used
+      else psiBs.push_back(exactApplyMPO(psi,B.mpo,args)) ;
+    } ;
+    open_tevol_file(filematrix,"TIME_EVOLUTION_MATRIX.OUT");
+  } ;
+  for (it=it0;it<nt;it++) { // loop
+	      if (every>0 and it>it0 and it%every==0)
+	        write_tevol_checkpoint(psi1,it,norm0) ; // steps done so far
+	      evolve(psi1); // evolve
               normalize(psi1); // normalize
 	      psi1 *= norm0 ; // restore initial norm
+	      if (multi) { // all the operators
+	        auto zs = tevol_local_elements(Bs,psi,psi1) ; // local ones
+	        for (size_t k=0;k<Bs.size();k++)
+	          if (not Bs.at(k).local) zs.at(k) = overlapC(psiBs.at(k),psi1) ;
+	        write_tevol_row(filematrix,zs) ;
+	        continue ;
+	      } ;
 	      auto z = overlapC(psi2,psi1) ; // overlap
 //	      auto z = overlapC(psi,psi1) ; // overlap
 	      // write in a file
@@ -78,6 +142,7 @@ static auto quench=[]() {
                        << std::setprecision(20)<< imag(z) << endl;
   } ;
   fileevol.close(); // close file
+  if (multi) filematrix.close(); // close file
   writeToFile("psi_time_evolution.mps",psi1);
 };
 
@@ -92,21 +157,24 @@ static auto evolution_AeiHtB=[]() {
   auto nt = get_int_value("tevol_nt"); // number of time steps
   auto dt = get_float_value("tevol_dt"); // delta of time
   int it;
-  auto args = Args("Cutoff=",cutoff,"Maxm=",maxm);
+  auto args = get_tevol_args() ; // arguments for the evolution
+  auto method = get_str("tevol_method") ; // method for the evolution
   // get the AutoMPO
   auto ampo = get_ampo(sites) ; // get the ampo for the Hamiltonian
-  auto expH = MPO(ampo);
-  if (get_bool("tevol_custom_exp")) 
-    expH = evoloperator(MPO(ampo),dt) ; // create Hamiltonian
-  else expH = toExpH<ITensor>(ampo,dt*Cplx_i); 
-  ofstream fileevol; // file for the evolution
-  fileevol.open("TIME_EVOLUTION.OUT"); // time evolution
+  auto expH = get_tevol_expmpo(method,ampo,dt*Cplx_i) ; // time step
   auto psi1 = read_wf(get_str("wfa_time_evolution.mps")) ;
   auto psi2 = read_wf(get_str("wfb_time_evolution.mps")) ;
+  Cplx norm0 = 1.0 ; // not used
+  int it0 = start_tevol_checkpoint(psi1,norm0) ; // first step
+  int every = get_tevol_checkpoint_every() ; // steps between checkpoints
+  ofstream fileevol; // file for the evolution
+  open_tevol_file(fileevol,"TIME_EVOLUTION.OUT"); // time evolution
   auto fittd = get_bool("tevol_fit_td") ; // use fitting method
-  for (it=0;it<nt;it++) { // loop
-	      if (fittd) fitApplyMPO(psi1,expH,psi1,args) ; // evolve
-	      if (not fittd) psi1 = exactApplyMPO(expH,psi1,args); // evolve
+  auto evolve = get_tevol_stepper(method,ampo,expH,-dt*Cplx_i,fittd,args) ;
+  for (it=it0;it<nt;it++) { // loop
+	      if (every>0 and it>it0 and it%every==0)
+	        write_tevol_checkpoint(psi1,it,norm0) ; // steps done so far
+	      evolve(psi1); // evolve
 	      auto z = overlapC(psi2,psi1) ; // overlap
 //	      auto z = overlapC(psi,psi1) ; // overlap
 	      // write in a file
@@ -132,26 +200,46 @@ static auto evolution_measure=[]() {
   auto nt = get_int_value("tevol_nt"); // number of time steps
   auto dt = get_float_value("tevol_dt"); // delta of time
   int it;
-  auto args = Args("Cutoff=",cutoff,"Maxm=",maxm);
+  auto args = get_tevol_args() ; // arguments for the evolution
+  auto method = get_str("tevol_method") ; // method for the evolution
   // get the AutoMPO
   auto ampo = get_ampo(sites) ; // get the ampo for the Hamiltonian
   // shift by the ground state energy
-  auto expH = MPO(ampo);
-  if (get_bool("tevol_custom_exp")) 
-    expH = evoloperator(MPO(ampo),dt) ; // create Hamiltonian
-  else expH = toExpH<ITensor>(ampo,dt*Cplx_i); 
+  auto expH = get_tevol_expmpo(method,ampo,dt*Cplx_i) ; // time step
+  Cplx norm0 = 1.0 ; // not used
+  int it0 = start_tevol_checkpoint(psi,norm0) ; // first step
+  int every = get_tevol_checkpoint_every() ; // steps between checkpoints
   ofstream fileevol; // file for the evolution
-  fileevol.open("TIME_EVOLUTION.OUT"); // time evolution
+  open_tevol_file(fileevol,"TIME_EVOLUTION.OUT"); // time evolution
   auto fittd = get_bool("tevol_fit_td") ; // use fitting method
-  for (it=0;it<nt;it++) { // loop
-	      if (fittd) fitApplyMPO(psi,expH,psi,args) ; // evolve
-	      if (not fittd) psi = exactApplyMPO(expH,psi,args); // evolve
+  auto evolve = get_tevol_stepper(method,ampo,expH,-dt*Cplx_i,fittd,args) ;
+  // several observables, <psi(t)|A_k|psi(t)> in each row
+  bool multi = get_bool("tevol_multioperators") ;
+  auto As = std::vector<TevolOperator>() ;
+  ofstream filematrix; // file for all the operators
+  if (multi) {
+    As = get_tevol_operators("time_evolution_multioperator",
+		    get_int_value("tevol_noperators")) ;
+    open_tevol_file(filematrix,"TIME_EVOLUTION_MATRIX.OUT");
+  } ;
+  for (it=it0;it<nt;it++) { // loop
+	      if (every>0 and it>it0 and it%every==0)
+	        write_tevol_checkpoint(psi,it,norm0) ; // steps done so far
+	      evolve(psi); // evolve
+	      if (multi) { // all the operators
+	        auto zs = tevol_local_elements(As,psi,psi) ; // local ones
+	        for (size_t k=0;k<As.size();k++)
+	          if (not As.at(k).local) zs.at(k) = overlapC(psi,As.at(k).mpo,psi);
+	        write_tevol_row(filematrix,zs) ;
+	        continue ;
+	      } ;
               auto z = overlapC(psi,A,psi) ;
 	      // write in a file
 	      fileevol << std::setprecision(20) << real(z) << "  "
                        << std::setprecision(20)<< imag(z) << endl;
   } ;
   fileevol.close(); // close file
+  if (multi) filematrix.close(); // close file
   writeToFile("psi_evolve_and_measure.mps",psi);
 };
 
@@ -167,21 +255,28 @@ static auto exponential_eMwf=[]() {
   auto dtr = get_float_value("tevol_dt_real"); // delta of time
   auto dti = get_float_value("tevol_dt_imag"); // delta of time
   auto nt0 = get_int_value("tevol_n"); // number of time steps
-  auto args = Args("Cutoff=",cutoff,"Maxm=",maxm);
+  auto args = get_tevol_args() ; // arguments for the evolution
+  auto method = get_str("tevol_method") ; // method for the evolution
   // get the AutoMPO
   auto ampo = get_ampo(sites) ; // get the ampo for the Hamiltonian
-  auto expH = MPO(ampo);
   Cplx tau = dti*Cplx_i+dtr;
 //  auto bw =  bandwidth(sites,MPO(ampo)); // bandwidth
 //  auto nt = int(round(bw*nt0));
   auto nt = nt0;
   auto taui = tau/nt; // small time step
-  if (get_bool("tevol_custom_exp")) 
-    expH = custom_exp(MPO(ampo),taui) ; // custom exponential
-  else expH = toExpH<ITensor>(ampo,taui); // exponential
+  auto expH = get_tevol_expmpo(method,ampo,taui) ; // exponential
   auto psi1 = read_wf("input_wavefunction.mps") ;
+  if (get_bool("tevol_adaptive")) { // steps chosen by their error
+    auto tol = get_float_value("tevol_dt_tol") ; // error of each step
+    if (tol<=0.0) tol = 1e-4 ; // default value
+    auto step = get_tau_stepper(method,ampo,get_bool("tevol_fit_td"),args) ;
+    exponential_adaptive(step,psi1,-tau,nt,tol) ;
+    writeToFile("output_wavefunction.mps",psi1);
+    return ;
+  } ;
+  auto evolve = get_evolver(method,ampo,expH,-taui,false,args) ;
   for (int it=1;it<=nt;it++) { // loop
-	      psi1 = exactApplyMPO(expH,psi1,args); // evolve
+	      evolve(psi1); // evolve
   };
   writeToFile("output_wavefunction.mps",psi1);
 };
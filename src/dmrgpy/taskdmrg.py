@@ -62,6 +62,7 @@ def write_tasks(self):
   fo.write(" noise = "+str(self.noise)+"\n") # maximum bond dimension
   fo.write(" cutoff = "+str(self.cutoff)+"\n") # maximum discarded weight
   fo.write(" nsweeps = "+str(self.nsweeps)+"\n") # maximum discarded weight
+  fo.write(" nthreads = "+str(self.nthreads)+"\n") # number of threads
   ### this is a special addition to allow for generic interactions ###
   fo.write("}\n")
   fo.close()
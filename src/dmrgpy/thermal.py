@@ -4,3 +4,28 @@
 
 
 
+import numpy as np
+
+
+def get_thermal(self,beta=1.0,nbeta=20,operators=[]):
+    """
+    Thermal properties with the purification of the thermal state,
+    in the grid of inverse temperatures beta*k/nbeta for k=0,...,nbeta.
+    Returns the inverse temperatures, the energies, the logarithms of
+    the partition function and the expectation values of the operators
+    """
+    task = {"thermal_purification":"true",
+            "thermal_dbeta":str(beta/nbeta),
+            "thermal_nbeta":str(int(nbeta)),
+            "thermal_noperators":str(len(operators)),
+            }
+    self.task = task # override tasks
+    for (k,A) in enumerate(operators): # write all the operators
+        name = "thermal_multioperator_"+str(k)+".in"
+        self.execute(lambda: A.write(name=name))
+    self.write_hamiltonian() # write the Hamiltonian to a file
+    self.run() # perform the calculation
+    m = self.execute(lambda: np.genfromtxt("THERMAL.OUT"))
+    m = np.atleast_2d(m) # read
+    vs = m[:,3::2] + 1j*m[:,4::2] # expectation values
+    return (m[:,0],m[:,1],m[:,2],vs)
@@ -9,6 +9,55 @@ from .edtk import timedependent as tded
 
 
 
+def checkpoint_task(self):
+    """Options for the checkpoints of the time evolution"""
+    return {"tevol_checkpoint":self.tevol_checkpoint>0,
+            "tevol_checkpoint_every":str(self.tevol_checkpoint),
+            "tevol_restart":self.tevol_restart}
+
+
+
+def adaptive_task(self):
+    """Options for the adaptive time step and bond dimension"""
+    if self.tevol_maxm_max is None: maxm_max = self.maxm
+    else: maxm_max = self.tevol_maxm_max
+    return {"tevol_adaptive":self.tevol_adaptive,
+            "tevol_dt_tol":str(self.tevol_dt_tol),
+            "tevol_truncation":str(self.tevol_truncation),
+            "tevol_maxm_max":str(maxm_max),
+            "tevol_max_substeps":str(self.tevol_max_substeps)}
+
+
+
+def expmpo_task(self):
+    """Options for the MPO of the time step, with tevol_custom_exp"""
+    if self.tevol_exp_maxm is None: maxm = 0 # no limit
+    else: maxm = self.tevol_exp_maxm
+    return {"tevol_exp_mpo":self.tevol_exp_mpo,
+            "tevol_exp_order":str(int(self.tevol_exp_order)),
+            "tevol_exp_maxm":str(int(maxm)),
+            "tevol_exp_tol":str(self.tevol_exp_tol),
+            "tevol_exp_error":str(self.tevol_exp_error).lower()}
+
+
+
+def get_expmpo_error(self):
+    """Return the orders, the estimated errors and the bond dimensions
+    of the MPO of the time step, from the last evolution with it"""
+    m = np.atleast_2d(self.get_file("EXP_MPO.OUT"))
+    return m[:,0].astype(int),m[:,1],m[:,2].astype(int)
+
+
+
+def get_adaptive_log(self):
+    """Return the times, substeps, bond dimensions, discarded weights,
+    errors and bond dimension profiles of the last adaptive evolution"""
+    m = np.atleast_2d(self.get_file("TIME_EVOLUTION_ADAPTIVE.OUT"))
+    return (m[:,0],m[:,1],m[:,2].astype(int),m[:,3],m[:,4],
+            m[:,5:].astype(int))
+
+
+
 def evolution_DC(self,mode="DMRG",**kwargs):
     if mode=="DMRG":  return evolution_dmrg_DC(self,**kwargs)
     if mode=="ED": 
@@ -17,6 +66,18 @@ def evolution_DC(self,mode="DMRG",**kwargs):
 
 
 
+def evolution_DC_many(self,A,Bs,mode="DMRG",**kwargs):
+    """Correlators of A with each B in Bs, as in evolution_DC, returns
+    the times and a matrix with the correlator of each B in the columns"""
+    if mode=="DMRG": return evolution_dmrg_DC_many(self,A,Bs,**kwargs)
+    if mode=="ED": # one evolution for each B
+        edobj = self.get_ED_obj() # get the ED object
+        out = [tded.evolution_DC(edobj,h=self.hamiltonian,name=[A,B],**kwargs)
+                for B in Bs]
+        return out[0][0],np.array([o[1] for o in out]).T
+
+
+
 def evolution_dmrg_DC(self,name="XX",nt=10000,dt=0.1,restart=True,**kwargs):
     name = operatornames.str2MO(self,name,**kwargs)
     if self.fit_td: fittd = "true"
@@ -29,7 +90,11 @@ def evolution_dmrg_DC(self,name="XX",nt=10000,dt=0.1,restart=True,**kwargs):
             "tevol_fit":fittd,
             "tevol_custom_exp":tevol_custom_exp,
             "tevol_dt":str(dt),
+            "tevol_method":self.tevol_method,
             }
+    task.update(checkpoint_task(self)) # checkpoints
+    task.update(adaptive_task(self)) # adaptive time step
+    task.update(expmpo_task(self)) # MPO of the time step
     self.task = task # override tasks
     if restart: # restart the calculation
       self.execute(lambda: os.system("cp psi_GS.mps psi_time_evolution.mps"))
@@ -44,6 +109,72 @@ def evolution_dmrg_DC(self,name="XX",nt=10000,dt=0.1,restart=True,**kwargs):
 
 
 
+def evolution_dmrg_DC_many(self,A,Bs,nt=10000,dt=0.1,restart=True):
+    """Same as evolution_dmrg_DC for the operators (A,B) with all the
+    B in Bs, using a single time evolution. Returns the times and
+    a matrix with the correlators of each B in the columns"""
+    if self.tevol_custom_exp: tevol_custom_exp = "true"
+    else: tevol_custom_exp = "false"
+    task = {"time_evolution":"true",
+            "tevol_nt":str(nt),
+            "tevol_fit":"true",
+            "tevol_custom_exp":tevol_custom_exp,
+            "tevol_dt":str(dt),
+            "tevol_method":self.tevol_method,
+            "tevol_multioperators":"true",
+            "tevol_noperators":str(len(Bs)),
+            }
+    task.update(checkpoint_task(self)) # checkpoints
+    task.update(adaptive_task(self)) # adaptive time step
+    task.update(expmpo_task(self)) # MPO of the time step
+    self.task = task # override tasks
+    if restart: # restart the calculation
+      self.execute(lambda: os.system("cp psi_GS.mps psi_time_evolution.mps"))
+    Ad = A.get_dagger()
+    self.execute(lambda: Ad.write(name="dc_multioperator_i.in"))
+    self.execute(lambda: Bs[0].write(name="dc_multioperator_j.in"))
+    for (k,B) in enumerate(Bs): # write all the operators
+        name = "dc_multioperator_j_"+str(k)+".in"
+        self.execute(lambda: B.write(name=name))
+    self.execute( lambda : taskdmrg.write_tasks(self)) # write tasks
+    self.execute( lambda : self.run()) # run calculation
+    m = self.get_file("TIME_EVOLUTION_MATRIX.OUT") # time evolution
+    m = np.array(m).reshape((nt,len(Bs),2)) # real and imaginary parts
+    ts = np.array([dt*ii for ii in range(nt)]) # times
+    return ts,m[:,:,0]-1j*m[:,:,1] # return
+
+
+
+def get_krylov_error(self):
+    """Return the Krylov dimension and the estimated error of each
+    step of the last time evolution with tevol_method = "krylov" """
+    m = np.atleast_2d(self.get_file("TIME_EVOLUTION_KRYLOV.OUT"))
+    return m[:,0].astype(int),m[:,1]
+
+
+
+def get_otoc(self,A=None,B=None,nt=100,dt=0.1,mode="infinite"):
+    """Evolve the operator A in the Heisenberg picture as an MPO, and
+    compute the OTOC <B A(t) B A(t)> at infinite temperature
+    (mode="infinite") or in the ground state (mode="GS").
+    Returns the times, the OTOC, the norm Tr(A(t)^dagger A(t))/Tr(1)
+    and the operator entanglement of A(t) in each bond"""
+    if B is None: B = A
+    task = {"heisenberg_evolution":"true",
+            "heisenberg_nt":str(int(nt)),
+            "heisenberg_dt":str(dt),
+            "heisenberg_state":mode,
+            }
+    self.task = task # override tasks
+    self.execute(lambda: A.write(name="heisenberg_A.in"))
+    self.execute(lambda: B.write(name="heisenberg_B.in"))
+    self.write_hamiltonian() # write the Hamiltonian to a file
+    self.run() # perform the calculation
+    m = np.atleast_2d(self.get_file("HEISENBERG.OUT"))
+    return (m[:,0],m[:,1]+1j*m[:,2],m[:,3],m[:,4:])
+
+
+
 def evolve_and_measure(self,mode="DMRG",**kwargs):
     """Evolve and measure"""
     if mode=="DMRG": return evolve_and_measure_dmrg(self,**kwargs)
@@ -67,16 +198,31 @@ def evolve_and_measure_dmrg(self,operator=None,nt=1000,h=None,
             "tevol_fit":fittd,
             "tevol_custom_exp":tevol_custom_exp,
             "tevol_dt":str(dt),
+            "tevol_method":self.tevol_method,
             }
+    task.update(checkpoint_task(self)) # checkpoints
+    task.update(adaptive_task(self)) # adaptive time step
+    task.update(expmpo_task(self)) # MPO of the time step
     self.task = task # override tasks
     if wf is None: wf = self.wf0 # get ground state
     wf.write(name="psi_evolve_and_measure.mps") # copy wavefunction
     self.execute(lambda: h.write(name="hamiltonian.in"))
+    if type(operator)==list: # several operators, in the same evolution
+        task["tevol_multioperators"] = "true"
+        task["tevol_noperators"] = str(len(operator))
+        for (k,A) in enumerate(operator): # write all the operators
+            name = "time_evolution_multioperator_"+str(k)+".in"
+            self.execute(lambda: A.write(name=name))
+        operator = operator[0]
     self.execute(lambda: operator.write(name="time_evolution_multioperator.in"))
     self.execute( lambda : taskdmrg.write_tasks(self)) # write tasks
     self.execute( lambda : self.run()) # run calculation
-    cs = self.get_file("TIME_EVOLUTION.OUT").transpose() # time evolution
     ts = np.array([dt*ii for ii in range(int(nt))]) # times
+    if "tevol_multioperators" in task: # one column per operator
+        m = self.get_file("TIME_EVOLUTION_MATRIX.OUT")
+        m = np.array(m).reshape((int(nt),-1,2)) # real and imaginary parts
+        return ts,m[:,:,0]-1j*m[:,:,1] # return
+    cs = self.get_file("TIME_EVOLUTION.OUT").transpose() # time evolution
     return ts,cs[0].real-1j*cs[1] # return
 
 